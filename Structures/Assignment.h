@@ -0,0 +1,450 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <cassert>
+
+#include "CsrGraph.h"
+#include "Dijkstra.h"
+#include "Kuhn.h"
+#include "HopcroftKarp.h"
+#include "../Utils/thread_pool.h"
+
+// INTERFACE
+
+namespace assignment {
+
+using Cost = dijkstra::Distance;
+using kuhn::Matching;
+
+// graph[left][right] is the cost of matching left with right
+using Graph = std::vector<std::unordered_map<size_t, Cost>>;
+
+// row-major in one contiguous array, a row is scanned as a plain array of costs
+class CostMatrix;
+
+struct Assignment {
+    std::vector<Matching> matching;
+    Cost cost = 0;
+};
+
+// Hungarian algorithm with potentials, O(n^2 m): matches every row with its own column at the
+// minimum total cost. Requires RowCount() <= ColumnCount(), transpose the matrix otherwise.
+// Matching is (row, column), in the order of rows.
+Assignment FindMinCostAssignment(const CostMatrix& costs);
+
+// Epsilon-scaling auction (Bertsekas) for sparse graphs: left vertexes bid for right vertexes,
+// costs are scaled by n + 1 so the last phase with epsilon = 1 gives the exact optimum. Bids of
+// a round are computed in parallel against frozen prices and every right vertex takes its
+// highest bid (Jacobi auction). The matching must be perfect: there must be a matching of all
+// left vertexes, and exactly as many right vertexes adjacent to them. With spare right vertexes
+// the prices kept between phases break the optimality, pad the left part instead. Both are
+// checked up front, as without a perfect matching the bids would never end. Absolute costs
+// must not exceed max / 8 / (n + 1), and the prices, which may grow to about n times the cost
+// range, must stay below max / 4. Throws std::runtime_error otherwise.
+// Matching is in the order of @left_part_vertexes.
+Assignment FindMinCostAssignmentAuction(const Graph& graph,
+                                        const std::vector<size_t>& left_part_vertexes,
+                                        size_t thread_count = std::thread::hardware_concurrency());
+
+Assignment FindMinCostAssignmentAuction(const Graph& graph, size_t first_part_size,
+                                        size_t thread_count = std::thread::hardware_concurrency());
+
+Assignment FindMinCostAssignmentAuction(const CsrGraph<Cost>& graph,
+                                        const std::vector<size_t>& left_part_vertexes,
+                                        size_t thread_count = std::thread::hardware_concurrency());
+
+Assignment FindMinCostAssignmentAuction(const CsrGraph<Cost>& graph, size_t first_part_size,
+                                        size_t thread_count = std::thread::hardware_concurrency());
+
+// IMPLEMENTATION
+
+class CostMatrix {
+public:
+    CostMatrix(size_t row_count, size_t column_count, Cost cost = 0)
+        : row_count_(row_count), column_count_(column_count),
+          costs_(row_count * column_count, cost) {
+    }
+
+    size_t RowCount() const {
+        return row_count_;
+    }
+
+    size_t ColumnCount() const {
+        return column_count_;
+    }
+
+    Cost& operator()(size_t row, size_t column) {
+        return costs_[row * column_count_ + column];
+    }
+
+    Cost operator()(size_t row, size_t column) const {
+        return costs_[row * column_count_ + column];
+    }
+
+    const Cost* GetRow(size_t row) const {
+        return costs_.data() + row * column_count_;
+    }
+
+private:
+    size_t row_count_;
+    size_t column_count_;
+    std::vector<Cost> costs_;
+};
+
+// Rows are added one by one, each by a Dijkstra-like search over reduced costs from the new row
+// to a free column. Column 0 of the arrays is a fictitious one holding the row being added,
+// real columns and rows are shifted by one.
+class HungarianFinder {
+public:
+    explicit HungarianFinder(const CostMatrix& costs)
+        : costs_(costs),
+          row_count_(costs.RowCount()),
+          column_count_(costs.ColumnCount()),
+          row_potentials_(row_count_ + 1, 0),
+          column_potentials_(column_count_ + 1, 0),
+          column_rows_(column_count_ + 1, 0),
+          previous_columns_(column_count_ + 1, 0),
+          min_reduced_costs_(column_count_ + 1),
+          used_(column_count_ + 1) {
+        assert(row_count_ <= column_count_);
+    }
+
+    Assignment Find() {
+        for (size_t row = 1; row <= row_count_; ++row) {
+            AddRow(row);
+        }
+        std::vector<size_t> row_columns(row_count_);
+        for (size_t column = 1; column <= column_count_; ++column) {
+            if (column_rows_[column] != 0) {
+                row_columns[column_rows_[column] - 1] = column - 1;
+            }
+        }
+        Assignment result;
+        for (size_t row = 0; row < row_count_; ++row) {
+            result.matching.emplace_back(row, row_columns[row]);
+            result.cost += costs_(row, row_columns[row]);
+        }
+        return result;
+    }
+
+private:
+    static constexpr Cost kInfCost = std::numeric_limits<Cost>::max();
+
+    const CostMatrix& costs_;
+    size_t row_count_;
+    size_t column_count_;
+    std::vector<Cost> row_potentials_;
+    std::vector<Cost> column_potentials_;
+    // 0 for a free column
+    std::vector<size_t> column_rows_;
+    // the column before this one on the shortest alternating path
+    std::vector<size_t> previous_columns_;
+    std::vector<Cost> min_reduced_costs_;
+    std::vector<char> used_;
+
+    void AddRow(size_t new_row) {
+        column_rows_[0] = new_row;
+        std::fill(min_reduced_costs_.begin(), min_reduced_costs_.end(), kInfCost);
+        std::fill(used_.begin(), used_.end(), 0);
+        size_t column = 0;
+        do {
+            used_[column] = 1;
+            size_t row = column_rows_[column];
+            const Cost* row_costs = costs_.GetRow(row - 1);
+            Cost row_potential = row_potentials_[row];
+            Cost delta = kInfCost;
+            size_t next_column = 0;
+            for (size_t other = 1; other <= column_count_; ++other) {
+                if (used_[other]) {
+                    continue;
+                }
+                Cost reduced_cost = row_costs[other - 1] - row_potential - column_potentials_[other];
+                if (reduced_cost < min_reduced_costs_[other]) {
+                    min_reduced_costs_[other] = reduced_cost;
+                    previous_columns_[other] = column;
+                }
+                if (min_reduced_costs_[other] < delta) {
+                    delta = min_reduced_costs_[other];
+                    next_column = other;
+                }
+            }
+            for (size_t other = 0; other <= column_count_; ++other) {
+                if (used_[other]) {
+                    row_potentials_[column_rows_[other]] += delta;
+                    column_potentials_[other] -= delta;
+                } else {
+                    min_reduced_costs_[other] -= delta;
+                }
+            }
+            column = next_column;
+        } while (column_rows_[column] != 0);
+
+        // shift the rows along the path, the fictitious column 0 gives @new_row
+        do {
+            size_t previous_column = previous_columns_[column];
+            column_rows_[column] = column_rows_[previous_column];
+            column = previous_column;
+        } while (column != 0);
+    }
+};
+
+Assignment FindMinCostAssignment(const CostMatrix& costs) {
+    return HungarianFinder(costs).Find();
+}
+
+// Left vertexes are persons, right vertexes are objects, benefit of an edge is its scaled cost
+// negated. Every phase starts with nobody assigned and keeps the prices of the previous one.
+template <class GraphType>
+class AuctionFinder {
+public:
+    static constexpr size_t kNoVertex = SIZE_MAX;
+
+    AuctionFinder(const GraphType& graph, const std::vector<size_t>& left_part_vertexes,
+                  size_t thread_count)
+        : graph_(graph),
+          left_part_vertexes_(left_part_vertexes),
+          thread_pool_(thread_count),
+          cost_scale_(static_cast<Cost>(left_part_vertexes.size()) + 1),
+          prices_(graph.size(), 0),
+          owners_(graph.size(), kNoVertex),
+          best_bids_(graph.size()),
+          winners_(graph.size()),
+          object_marks_(graph.size()),
+          bids_(graph.size()),
+          thread_lists_(thread_pool_.Size()) {
+        Cost min_benefit = 0;
+        Cost max_benefit = 0;
+        size_t object_count = 0;
+        std::vector<std::pair<size_t, size_t>> support;
+        for (size_t person : left_part_vertexes_) {
+            for (const auto& [object, cost] : graph_[person]) {
+                if (cost > kBenefitLimit / cost_scale_ || cost < -kBenefitLimit / cost_scale_) {
+                    throw std::runtime_error("assignment costs are too large");
+                }
+                min_benefit = std::min(min_benefit, -cost * cost_scale_);
+                max_benefit = std::max(max_benefit, -cost * cost_scale_);
+                support.emplace_back(person, object);
+                if (owners_[object] == kNoVertex) {
+                    owners_[object] = person;
+                    ++object_count;
+                }
+            }
+        }
+        if (object_count != left_part_vertexes_.size() ||
+            hopcroft_karp::FindMaxMatchingHopcroftKarp(MakeCsrGraph(graph.size(), support),
+                                                       left_part_vertexes_)
+                    .size() != left_part_vertexes_.size()) {
+            throw std::runtime_error("assignment has no perfect matching");
+        }
+        std::fill(owners_.begin(), owners_.end(), kNoVertex);
+        benefit_range_ = max_benefit - min_benefit;
+        for (size_t vertex = 0; vertex < graph.size(); ++vertex) {
+            best_bids_[vertex].store(kNoBid, std::memory_order_relaxed);
+            winners_[vertex].store(kNoVertex, std::memory_order_relaxed);
+            object_marks_[vertex].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    Assignment Find() {
+        Cost epsilon = std::max<Cost>(benefit_range_ / kEpsilonFactor, 1);
+        while (true) {
+            RunPhase(epsilon);
+            if (epsilon == 1) {
+                break;
+            }
+            epsilon = std::max<Cost>(epsilon / kEpsilonFactor, 1);
+        }
+        Assignment result;
+        for (size_t person : left_part_vertexes_) {
+            const Bid& bid = bids_[person];
+            result.matching.emplace_back(person, bid.object);
+            result.cost += bid.cost;
+        }
+        return result;
+    }
+
+private:
+    static constexpr size_t kChunkSize = 256;
+    static constexpr Cost kEpsilonFactor = 8;
+    static constexpr Cost kNoBid = std::numeric_limits<Cost>::min();
+    // with scaled costs and prices below them values and bids do not overflow
+    static constexpr Cost kBenefitLimit = std::numeric_limits<Cost>::max() / 8;
+    static constexpr Cost kPriceLimit = std::numeric_limits<Cost>::max() / 4;
+
+    struct Bid {
+        size_t object = kNoVertex;
+        Cost price = 0;
+        // unscaled cost of the edge to object
+        Cost cost = 0;
+    };
+
+    const GraphType& graph_;
+    const std::vector<size_t>& left_part_vertexes_;
+    ThreadPool thread_pool_;
+    Cost cost_scale_;
+    Cost benefit_range_ = 0;
+
+    // prices_ and owners_ are indexed by objects and change only between rounds
+    std::vector<Cost> prices_;
+    std::vector<size_t> owners_;
+    std::vector<std::atomic<Cost>> best_bids_;
+    std::vector<std::atomic<size_t>> winners_;
+    // an object joins bid_objects_ at most once per round
+    uint64_t round_ = 0;
+    std::vector<std::atomic<uint64_t>> object_marks_;
+
+    // indexed by persons: the last bid, which is also the assignment once it wins
+    std::vector<Bid> bids_;
+    std::vector<size_t> unassigned_;
+    std::vector<size_t> bidders_;
+    std::vector<size_t> bid_objects_;
+    std::vector<std::vector<size_t>> thread_lists_;
+    // set by a bid above kPriceLimit, checked between rounds
+    std::atomic<bool> is_price_overflow_{false};
+
+    // @task(index, thread_index) for every index in [0, count), in chunks; a single chunk
+    // runs on the calling thread, the last rounds of a phase have few bidders
+    template <class Task>
+    void ForEachChunked(size_t count, const Task& task) {
+        if (count <= kChunkSize) {
+            for (size_t index = 0; index < count; ++index) {
+                task(index, 0);
+            }
+            return;
+        }
+        std::atomic<size_t> next_chunk{0};
+        thread_pool_.Run([&](size_t thread_index) {
+            size_t begin;
+            while ((begin = next_chunk.fetch_add(kChunkSize)) < count) {
+                size_t end = std::min(begin + kChunkSize, count);
+                for (size_t index = begin; index < end; ++index) {
+                    task(index, thread_index);
+                }
+            }
+        });
+    }
+
+    void GatherThreadLists(std::vector<size_t>* vertexes) {
+        vertexes->clear();
+        for (std::vector<size_t>& list : thread_lists_) {
+            vertexes->insert(vertexes->end(), list.begin(), list.end());
+            list.clear();
+        }
+    }
+
+    void RunPhase(Cost epsilon) {
+        for (size_t person : left_part_vertexes_) {
+            if (bids_[person].object != kNoVertex) {
+                owners_[bids_[person].object] = kNoVertex;
+            }
+        }
+        unassigned_ = left_part_vertexes_;
+        while (!unassigned_.empty()) {
+            ++round_;
+            bidders_.swap(unassigned_);
+            ForEachChunked(bidders_.size(), [&](size_t index, size_t thread_index) {
+                MakeBid(bidders_[index], epsilon, thread_index);
+            });
+            GatherThreadLists(&bid_objects_);
+            if (is_price_overflow_.load()) {
+                throw std::runtime_error("assignment prices overflow");
+            }
+
+            // ties are broken by whoever comes first, losers bid again in the next round
+            ForEachChunked(bidders_.size(), [&](size_t index, size_t thread_index) {
+                size_t person = bidders_[index];
+                size_t object = bids_[person].object;
+                size_t no_winner = kNoVertex;
+                if (bids_[person].price != best_bids_[object].load(std::memory_order_relaxed) ||
+                    !winners_[object].compare_exchange_strong(no_winner, person,
+                                                              std::memory_order_relaxed)) {
+                    thread_lists_[thread_index].push_back(person);
+                }
+            });
+
+            ForEachChunked(bid_objects_.size(), [&](size_t index, size_t thread_index) {
+                size_t object = bid_objects_[index];
+                if (owners_[object] != kNoVertex) {
+                    thread_lists_[thread_index].push_back(owners_[object]);
+                }
+                owners_[object] = winners_[object].exchange(kNoVertex, std::memory_order_relaxed);
+                prices_[object] = best_bids_[object].exchange(kNoBid, std::memory_order_relaxed);
+            });
+            GatherThreadLists(&unassigned_);
+        }
+    }
+
+    // the best object for @person at the current prices, bid up to the point where the second
+    // best one is worse only by @epsilon
+    void MakeBid(size_t person, Cost epsilon, size_t thread_index) {
+        Bid& bid = bids_[person];
+        bid.object = kNoVertex;
+        Cost best_value = kNoBid;
+        Cost second_value = kNoBid;
+        for (const auto& [object, cost] : graph_[person]) {
+            Cost value = -cost * cost_scale_ - prices_[object];
+            if (value > best_value) {
+                second_value = best_value;
+                best_value = value;
+                bid.object = object;
+                bid.cost = cost;
+            } else if (value > second_value) {
+                second_value = value;
+            }
+        }
+        assert(bid.object != kNoVertex);
+        if (second_value == kNoBid) {
+            second_value = best_value - benefit_range_;
+        }
+        bid.price = prices_[bid.object] + best_value - second_value + epsilon;
+        if (bid.price > kPriceLimit) {
+            is_price_overflow_.store(true, std::memory_order_relaxed);
+            bid.price = kPriceLimit;
+        }
+
+        std::atomic<Cost>& best_bid = best_bids_[bid.object];
+        Cost current = best_bid.load(std::memory_order_relaxed);
+        while (current < bid.price &&
+               !best_bid.compare_exchange_weak(current, bid.price, std::memory_order_relaxed)) {
+        }
+        std::atomic<uint64_t>& mark = object_marks_[bid.object];
+        if (mark.load(std::memory_order_relaxed) != round_ &&
+            mark.exchange(round_, std::memory_order_relaxed) != round_) {
+            thread_lists_[thread_index].push_back(bid.object);
+        }
+    }
+};
+
+Assignment FindMinCostAssignmentAuction(const Graph& graph,
+                                        const std::vector<size_t>& left_part_vertexes,
+                                        size_t thread_count) {
+    return AuctionFinder<Graph>(graph, left_part_vertexes, thread_count).Find();
+}
+
+Assignment FindMinCostAssignmentAuction(const Graph& graph, size_t first_part_size,
+                                        size_t thread_count) {
+    return FindMinCostAssignmentAuction(graph, kuhn::MakeFirstPartVertexes(first_part_size),
+                                        thread_count);
+}
+
+Assignment FindMinCostAssignmentAuction(const CsrGraph<Cost>& graph,
+                                        const std::vector<size_t>& left_part_vertexes,
+                                        size_t thread_count) {
+    return AuctionFinder<CsrGraph<Cost>>(graph, left_part_vertexes, thread_count).Find();
+}
+
+Assignment FindMinCostAssignmentAuction(const CsrGraph<Cost>& graph, size_t first_part_size,
+                                        size_t thread_count) {
+    return FindMinCostAssignmentAuction(graph, kuhn::MakeFirstPartVertexes(first_part_size),
+                                        thread_count);
+}
+
+}  // namespace assignment
+
+using namespace assignment;
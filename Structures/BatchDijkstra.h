@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+#include <optional>
+
+#include "CsrGraph.h"
+#include "Dijkstra.h"
+#include "DijkstraEngine.h"
+#include "../Utils/thread_pool.h"
+
+// INTERFACE
+
+namespace dijkstra {
+
+// Runs Dijkstra from every source concurrently. @distances is a caller-provided row-major
+// sources.size() x graph.size() matrix, row i receives Dijkstra(graph, sources[i]).
+// Every thread keeps one DijkstraEngine, so buffers are allocated once per thread, not per source.
+void BatchDijkstra(const Graph& graph, const std::vector<Vertex>& sources, Distance* distances,
+                   size_t thread_count = std::thread::hardware_concurrency());
+
+void BatchDijkstra(const CsrGraph<Distance>& graph, const std::vector<Vertex>& sources,
+                   Distance* distances,
+                   size_t thread_count = std::thread::hardware_concurrency());
+
+// the same with a pool shared between calls
+void BatchDijkstra(const Graph& graph, const std::vector<Vertex>& sources, Distance* distances,
+                   ThreadPool* thread_pool);
+
+void BatchDijkstra(const CsrGraph<Distance>& graph, const std::vector<Vertex>& sources,
+                   Distance* distances, ThreadPool* thread_pool);
+
+// IMPLEMENTATION
+
+template <class GraphType>
+void FindBatchDistancesDijkstra(const GraphType& graph, const std::vector<Vertex>& sources,
+                                Distance* distances, ThreadPool* thread_pool) {
+    // engines are created lazily by their threads, so every buffer is first touched by its owner
+    std::vector<std::optional<DijkstraEngine<GraphType>>> engines(thread_pool->Size());
+    thread_pool->ParallelFor(sources.size(), [&](size_t index, size_t thread_index) {
+        auto& engine = engines[thread_index];
+        if (!engine) {
+            engine.emplace(graph);
+        }
+        engine->Query(sources[index]);
+        engine->WriteDistances(distances + index * graph.size());
+    });
+}
+
+void BatchDijkstra(const Graph& graph, const std::vector<Vertex>& sources, Distance* distances,
+                   size_t thread_count) {
+    ThreadPool thread_pool(thread_count);
+    FindBatchDistancesDijkstra(graph, sources, distances, &thread_pool);
+}
+
+void BatchDijkstra(const CsrGraph<Distance>& graph, const std::vector<Vertex>& sources,
+                   Distance* distances, size_t thread_count) {
+    ThreadPool thread_pool(thread_count);
+    FindBatchDistancesDijkstra(graph, sources, distances, &thread_pool);
+}
+
+void BatchDijkstra(const Graph& graph, const std::vector<Vertex>& sources, Distance* distances,
+                   ThreadPool* thread_pool) {
+    FindBatchDistancesDijkstra(graph, sources, distances, thread_pool);
+}
+
+void BatchDijkstra(const CsrGraph<Distance>& graph, const std::vector<Vertex>& sources,
+                   Distance* distances, ThreadPool* thread_pool) {
+    FindBatchDistancesDijkstra(graph, sources, distances, thread_pool);
+}
+
+}  // namespace dijkstra
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+#include <optional>
+#include <utility>
+
+#include "Dinic.h"
+#include "../Utils/thread_pool.h"
+
+// INTERFACE
+
+namespace dinic {
+
+struct MinFlowEdgeCut {
+    Capacity flow = 0;
+    // pair represents edge (from -> to)
+    std::vector<std::pair<size_t, size_t>> edges;
+};
+
+// FindMinFlowEdgeCut for every (source, target) of @queries, concurrently. The flow network is
+// built from @graph once; every thread copies it and only resets the flow between queries.
+std::vector<MinFlowEdgeCut> FindMinFlowEdgeCuts(
+    const Graph& graph, const std::vector<std::pair<size_t, size_t>>& queries,
+    size_t thread_count = std::thread::hardware_concurrency());
+
+// the same with a pool shared between calls
+std::vector<MinFlowEdgeCut> FindMinFlowEdgeCuts(
+    const Graph& graph, const std::vector<std::pair<size_t, size_t>>& queries,
+    ThreadPool* thread_pool);
+
+// IMPLEMENTATION
+
+std::vector<MinFlowEdgeCut> FindMinFlowEdgeCuts(
+    const Graph& graph, const std::vector<std::pair<size_t, size_t>>& queries,
+    size_t thread_count) {
+    ThreadPool thread_pool(thread_count);
+    return FindMinFlowEdgeCuts(graph, queries, &thread_pool);
+}
+
+std::vector<MinFlowEdgeCut> FindMinFlowEdgeCuts(
+    const Graph& graph, const std::vector<std::pair<size_t, size_t>>& queries,
+    ThreadPool* thread_pool) {
+    FlowNetwork network = MakeFlowNetwork(graph);
+    network.PrepareAdjacency();
+
+    std::vector<MinFlowEdgeCut> cuts(queries.size());
+    // finders are created lazily by their threads, so every copy is first touched by its owner
+    std::vector<std::optional<MinFlowEdgeCutFinder>> finders(thread_pool->Size());
+    thread_pool->ParallelFor(queries.size(), [&](size_t index, size_t thread_index) {
+        auto& finder = finders[thread_index];
+        if (!finder) {
+            finder.emplace(graph, network);
+        }
+        const auto& [source, target] = queries[index];
+        cuts[index].edges = finder->Find(source, target, &cuts[index].flow);
+    });
+    return cuts;
+}
+
+}  // namespace dinic
@@ -2,54 +2,120 @@
 
 #include <vector>
 #include <unordered_set>
+#include <cstdint>
 
+#include "CsrGraph.h"
 
 // INTERFACE
+
+namespace connected_components {
+
 using Graph = std::vector<std::vector<size_t>>;
 
 using ConnectedComponent = std::unordered_set<size_t>;
 
+// components are numbered 0, 1, ... in the order of their smallest vertexes
+struct ComponentLabels {
+    // component of every vertex
+    std::vector<size_t> labels;
+    // vertex count of every component
+    std::vector<size_t> sizes;
+};
+
 std::vector<ConnectedComponent> FindConnectedComponents(const Graph& graph);
 
+std::vector<ConnectedComponent> FindConnectedComponents(const CsrGraph<>& graph);
+
+std::vector<ConnectedComponent> FindConnectedComponents(const CsrGraphView<>& graph);
+
+// the same components as dense arrays, by BFS with an explicit queue
+ComponentLabels FindComponentLabels(const Graph& graph);
+
+ComponentLabels FindComponentLabels(const CsrGraph<>& graph);
+
+ComponentLabels FindComponentLabels(const CsrGraphView<>& graph);
 
 
 // IMPLEMENTATION
 
+template <class GraphType>
 class ConnectedComponentFinder {
 public:
-    explicit ConnectedComponentFinder(const Graph& graph) : graph_(graph), used_(graph.size()) {
+    static constexpr size_t kNoLabel = SIZE_MAX;
+
+    explicit ConnectedComponentFinder(const GraphType& graph) : graph_(graph) {
     }
 
-    std::vector<ConnectedComponent> Find() {
-        std::vector<ConnectedComponent> components;
+    ComponentLabels Find() {
+        ComponentLabels result;
+        result.labels.assign(graph_.size(), kNoLabel);
         for (size_t vertex = 0; vertex < graph_.size(); ++vertex) {
-            if (used_[vertex]) {
+            if (result.labels[vertex] != kNoLabel) {
                 continue;
             }
-            ConnectedComponent component;
-            AddAllConnectedVertexes(vertex, &component);
-            components.push_back(component);
+            result.sizes.push_back(LabelAllConnectedVertexes(vertex, result.sizes.size(),
+                                                             &result.labels));
         }
-        return components;
+        return result;
     }
 
 private:
-    const Graph& graph_;
-    std::vector<bool> used_;
-
-    void AddAllConnectedVertexes(size_t vertex, ConnectedComponent* component_ptr) {
-        component_ptr->insert(vertex);
-        used_[vertex] = true;
+    const GraphType& graph_;
+    std::vector<size_t> vertex_queue_;
 
-        for (size_t neighbor : graph_[vertex]) {
-            if (used_[neighbor]) {
-                continue;
+    // returns the component size
+    size_t LabelAllConnectedVertexes(size_t vertex, size_t label, std::vector<size_t>* labels) {
+        vertex_queue_.clear();
+        vertex_queue_.push_back(vertex);
+        (*labels)[vertex] = label;
+        for (size_t index = 0; index < vertex_queue_.size(); ++index) {
+            for (size_t neighbor : graph_[vertex_queue_[index]]) {
+                if ((*labels)[neighbor] != kNoLabel) {
+                    continue;
+                }
+                (*labels)[neighbor] = label;
+                vertex_queue_.push_back(neighbor);
             }
-            AddAllConnectedVertexes(neighbor, component_ptr);
         }
+        return vertex_queue_.size();
     }
 };
 
+std::vector<ConnectedComponent> MakeConnectedComponents(const ComponentLabels& components) {
+    std::vector<ConnectedComponent> result(components.sizes.size());
+    for (size_t label = 0; label < result.size(); ++label) {
+        result[label].reserve(components.sizes[label]);
+    }
+    for (size_t vertex = 0; vertex < components.labels.size(); ++vertex) {
+        result[components.labels[vertex]].insert(vertex);
+    }
+    return result;
+}
+
 std::vector<ConnectedComponent> FindConnectedComponents(const Graph& graph) {
+    return MakeConnectedComponents(FindComponentLabels(graph));
+}
+
+std::vector<ConnectedComponent> FindConnectedComponents(const CsrGraph<>& graph) {
+    return MakeConnectedComponents(FindComponentLabels(graph));
+}
+
+std::vector<ConnectedComponent> FindConnectedComponents(const CsrGraphView<>& graph) {
+    return MakeConnectedComponents(FindComponentLabels(graph));
+}
+
+ComponentLabels FindComponentLabels(const Graph& graph) {
+    return ConnectedComponentFinder(graph).Find();
+}
+
+ComponentLabels FindComponentLabels(const CsrGraph<>& graph) {
     return ConnectedComponentFinder(graph).Find();
 }
+
+ComponentLabels FindComponentLabels(const CsrGraphView<>& graph) {
+    return ConnectedComponentFinder(graph).Find();
+}
+
+}  // namespace connected_components
+
+using namespace connected_components;
@@ -0,0 +1,629 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <tuple>
+#include <string>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <algorithm>
+#include <stdexcept>
+#include <cassert>
+
+#include "CsrGraph.h"
+#include "Dijkstra.h"
+#include "ShortestPath.h"
+#include "../Utils/mapped_file.h"
+
+// INTERFACE
+
+namespace dijkstra {
+
+// Edges of one search direction in CSR form. middles[edge] is the contracted vertex
+// a shortcut goes through, kNoVertex for original edges.
+struct HierarchyEdgesView {
+    const size_t* offsets;
+    const size_t* targets;
+    const Distance* weights;
+    const Vertex* middles;
+};
+
+// Non-owning view over a hierarchy, either built in memory or mapped from a file.
+// upward[v] holds edges v -> w with ranks[w] > ranks[v],
+// backward[v] holds edges u -> v with ranks[u] > ranks[v] (stored as v -> u).
+struct ContractionHierarchyView {
+    size_t vertex_count;
+    const size_t* ranks;
+    HierarchyEdgesView upward;
+    HierarchyEdgesView backward;
+};
+
+class ContractionHierarchy;
+
+// contracts vertexes one by one in edge difference order; a witness search which settles more
+// than @witness_settle_limit vertexes gives up and the shortcut is added anyway
+ContractionHierarchy BuildContractionHierarchy(const Graph& graph,
+                                               size_t witness_settle_limit = 500);
+
+ContractionHierarchy BuildContractionHierarchy(const CsrGraph<Distance>& graph,
+                                               size_t witness_settle_limit = 500);
+
+// binary format: header, ranks, then offsets, targets, weights and middles of upward
+// and backward edges; every value is 8 bytes in native byte order
+void SaveContractionHierarchy(const ContractionHierarchy& hierarchy, const std::string& path);
+
+// maps a file written by SaveContractionHierarchy and checks it in one pass, throws
+// std::runtime_error on a bad file
+class MappedContractionHierarchy;
+
+// bidirectional upward Dijkstra, keeps its buffers between queries
+class ContractionHierarchyQuery;
+
+// IMPLEMENTATION
+
+struct HierarchyEdges {
+    std::vector<size_t> offsets{0};
+    std::vector<size_t> targets;
+    std::vector<Distance> weights;
+    std::vector<Vertex> middles;
+
+    HierarchyEdgesView GetView() const {
+        return {offsets.data(), targets.data(), weights.data(), middles.data()};
+    }
+};
+
+class ContractionHierarchy {
+public:
+    ContractionHierarchy(std::vector<size_t> ranks, HierarchyEdges upward, HierarchyEdges backward)
+        : ranks_(std::move(ranks)), upward_(std::move(upward)), backward_(std::move(backward)) {
+    }
+
+    ContractionHierarchyView GetView() const {
+        return {ranks_.size(), ranks_.data(), upward_.GetView(), backward_.GetView()};
+    }
+
+    size_t GetShortcutCount() const {
+        return std::count_if(upward_.middles.begin(), upward_.middles.end(),
+                             [](Vertex middle) { return middle != kNoVertex; }) +
+               std::count_if(backward_.middles.begin(), backward_.middles.end(),
+                             [](Vertex middle) { return middle != kNoVertex; });
+    }
+
+private:
+    std::vector<size_t> ranks_;
+    HierarchyEdges upward_;
+    HierarchyEdges backward_;
+};
+
+class ContractionHierarchyBuilder {
+public:
+    ContractionHierarchyBuilder(size_t vertex_count, size_t witness_settle_limit)
+        : out_edges_(vertex_count),
+          in_edges_(vertex_count),
+          contracted_(vertex_count),
+          contracted_neighbours_(vertex_count),
+          witness_settle_limit_(witness_settle_limit),
+          witness_distances_(vertex_count, kInfDistance),
+          upward_lists_(vertex_count),
+          backward_lists_(vertex_count) {
+    }
+
+    void AddEdge(Vertex from, Vertex to, Distance weight) {
+        assert(weight >= 0);
+        if (from == to) {
+            return;
+        }
+        auto [iter, inserted] = out_edges_[from].try_emplace(to, HierarchyEdge{weight, kNoVertex});
+        if (!inserted && weight < iter->second.weight) {
+            iter->second.weight = weight;
+        }
+        in_edges_[to][from] = iter->second;
+    }
+
+    ContractionHierarchy Build() {
+        size_t vertex_count = out_edges_.size();
+        using Entry = std::pair<long long, Vertex>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<>> queue;
+        for (Vertex vertex = 0; vertex < vertex_count; ++vertex) {
+            queue.emplace(GetPriority(vertex), vertex);
+        }
+
+        std::vector<size_t> ranks(vertex_count);
+        size_t rank = 0;
+        while (!queue.empty()) {
+            Vertex vertex = queue.top().second;
+            queue.pop();
+            // lazy update: the priority is recomputed and the vertex is postponed if it got worse
+            long long priority = GetPriority(vertex);
+            if (!queue.empty() && priority > queue.top().first) {
+                queue.emplace(priority, vertex);
+                continue;
+            }
+            ranks[vertex] = rank++;
+            Contract(vertex);
+        }
+        return {std::move(ranks), Flatten(upward_lists_), Flatten(backward_lists_)};
+    }
+
+private:
+    struct HierarchyEdge {
+        Distance weight;
+        Vertex middle;
+    };
+
+    struct Shortcut {
+        Vertex from;
+        Vertex to;
+        Distance weight;
+    };
+
+    using EdgeMap = std::unordered_map<Vertex, HierarchyEdge>;
+
+    std::vector<EdgeMap> out_edges_;
+    std::vector<EdgeMap> in_edges_;
+    std::vector<bool> contracted_;
+    std::vector<size_t> contracted_neighbours_;
+
+    size_t witness_settle_limit_;
+    std::vector<Distance> witness_distances_;
+    std::vector<Vertex> witness_touched_;
+
+    std::vector<std::vector<std::tuple<Vertex, Distance, Vertex>>> upward_lists_;
+    std::vector<std::vector<std::tuple<Vertex, Distance, Vertex>>> backward_lists_;
+
+    long long GetPriority(Vertex vertex) {
+        long long shortcut_count = FindShortcuts(vertex).size();
+        long long removed_count = out_edges_[vertex].size() + in_edges_[vertex].size();
+        return shortcut_count - removed_count + contracted_neighbours_[vertex];
+    }
+
+    // shortcuts u -> w through @vertex for which no witness path avoiding @vertex is found
+    std::vector<Shortcut> FindShortcuts(Vertex vertex) {
+        std::vector<Shortcut> shortcuts;
+        if (out_edges_[vertex].empty()) {
+            return shortcuts;
+        }
+        for (const auto& [from, in_edge] : in_edges_[vertex]) {
+            Distance max_distance = 0;
+            for (const auto& [to, out_edge] : out_edges_[vertex]) {
+                max_distance = std::max(max_distance, in_edge.weight + out_edge.weight);
+            }
+            RunWitnessSearch(from, vertex, max_distance);
+            for (const auto& [to, out_edge] : out_edges_[vertex]) {
+                if (to == from) {
+                    continue;
+                }
+                Distance distance = in_edge.weight + out_edge.weight;
+                if (witness_distances_[to] == kInfDistance || witness_distances_[to] > distance) {
+                    shortcuts.push_back({from, to, distance});
+                }
+            }
+        }
+        return shortcuts;
+    }
+
+    // distances from @source in the remaining graph without @excluded_vertex, up to @max_distance
+    void RunWitnessSearch(Vertex source, Vertex excluded_vertex, Distance max_distance) {
+        for (Vertex vertex : witness_touched_) {
+            witness_distances_[vertex] = kInfDistance;
+        }
+        witness_touched_.clear();
+
+        using Entry = std::pair<Distance, Vertex>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<>> queue;
+        witness_distances_[source] = 0;
+        witness_touched_.push_back(source);
+        queue.emplace(0, source);
+        size_t settled_count = 0;
+        while (!queue.empty() && settled_count < witness_settle_limit_) {
+            auto [distance, vertex] = queue.top();
+            queue.pop();
+            if (distance != witness_distances_[vertex]) {
+                continue;
+            }
+            if (distance > max_distance) {
+                break;
+            }
+            ++settled_count;
+            for (const auto& [to, edge] : out_edges_[vertex]) {
+                if (to == excluded_vertex) {
+                    continue;
+                }
+                Distance new_distance = distance + edge.weight;
+                if (witness_distances_[to] == kInfDistance) {
+                    witness_touched_.push_back(to);
+                } else if (witness_distances_[to] <= new_distance) {
+                    continue;
+                }
+                witness_distances_[to] = new_distance;
+                queue.emplace(new_distance, to);
+            }
+        }
+    }
+
+    void Contract(Vertex vertex) {
+        std::vector<Shortcut> shortcuts = FindShortcuts(vertex);
+
+        // remaining edges of the vertex lead to vertexes which will get higher ranks
+        for (const auto& [to, edge] : out_edges_[vertex]) {
+            upward_lists_[vertex].emplace_back(to, edge.weight, edge.middle);
+            in_edges_[to].erase(vertex);
+            ++contracted_neighbours_[to];
+        }
+        for (const auto& [from, edge] : in_edges_[vertex]) {
+            backward_lists_[vertex].emplace_back(from, edge.weight, edge.middle);
+            out_edges_[from].erase(vertex);
+            ++contracted_neighbours_[from];
+        }
+        out_edges_[vertex].clear();
+        in_edges_[vertex].clear();
+        contracted_[vertex] = true;
+
+        for (const Shortcut& shortcut : shortcuts) {
+            auto [iter, inserted] = out_edges_[shortcut.from].try_emplace(
+                shortcut.to, HierarchyEdge{shortcut.weight, vertex});
+            if (!inserted) {
+                if (shortcut.weight >= iter->second.weight) {
+                    continue;
+                }
+                iter->second = {shortcut.weight, vertex};
+            }
+            in_edges_[shortcut.to][shortcut.from] = iter->second;
+        }
+    }
+
+    static HierarchyEdges Flatten(
+        const std::vector<std::vector<std::tuple<Vertex, Distance, Vertex>>>& lists) {
+        HierarchyEdges edges;
+        for (const auto& list : lists) {
+            for (const auto& [to, weight, middle] : list) {
+                edges.targets.push_back(to);
+                edges.weights.push_back(weight);
+                edges.middles.push_back(middle);
+            }
+            edges.offsets.push_back(edges.targets.size());
+        }
+        return edges;
+    }
+};
+
+ContractionHierarchy BuildContractionHierarchy(const Graph& graph, size_t witness_settle_limit) {
+    ContractionHierarchyBuilder builder(graph.size(), witness_settle_limit);
+    for (Vertex from = 0; from < graph.size(); ++from) {
+        for (const auto& [to, weight] : graph[from]) {
+            builder.AddEdge(from, to, weight);
+        }
+    }
+    return builder.Build();
+}
+
+ContractionHierarchy BuildContractionHierarchy(const CsrGraph<Distance>& graph,
+                                               size_t witness_settle_limit) {
+    ContractionHierarchyBuilder builder(graph.size(), witness_settle_limit);
+    for (Vertex from = 0; from < graph.size(); ++from) {
+        for (const auto& [to, weight] : graph[from]) {
+            builder.AddEdge(from, to, weight);
+        }
+    }
+    return builder.Build();
+}
+
+struct ContractionHierarchyFileHeader {
+    static constexpr char kMagic[8] = {'A', 'L', 'G', 'O', '-', 'C', 'H', '\0'};
+    static constexpr uint64_t kVersion = 1;
+
+    char magic[8];
+    uint64_t version;
+    uint64_t vertex_count;
+    uint64_t upward_edge_count;
+    uint64_t backward_edge_count;
+};
+
+static_assert(sizeof(size_t) == 8 && sizeof(Distance) == 8);
+
+void SaveContractionHierarchy(const ContractionHierarchy& hierarchy, const std::string& path) {
+    ContractionHierarchyView view = hierarchy.GetView();
+    size_t vertex_count = view.vertex_count;
+    ContractionHierarchyFileHeader header;
+    std::memcpy(header.magic, ContractionHierarchyFileHeader::kMagic, sizeof(header.magic));
+    header.version = ContractionHierarchyFileHeader::kVersion;
+    header.vertex_count = vertex_count;
+    header.upward_edge_count = view.upward.offsets[vertex_count];
+    header.backward_edge_count = view.backward.offsets[vertex_count];
+
+    std::ofstream out(path, std::ios::binary);
+    auto write = [&out](const void* data, size_t count) {
+        out.write(static_cast<const char*>(data), count * 8);
+    };
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    write(view.ranks, vertex_count);
+    for (const auto& [edges, edge_count] : {std::make_pair(view.upward, header.upward_edge_count),
+                                            std::make_pair(view.backward, header.backward_edge_count)}) {
+        write(edges.offsets, vertex_count + 1);
+        write(edges.targets, edge_count);
+        write(edges.weights, edge_count);
+        write(edges.middles, edge_count);
+    }
+    if (!out) {
+        throw std::runtime_error("can not write " + path);
+    }
+}
+
+class MappedContractionHierarchy {
+public:
+    explicit MappedContractionHierarchy(const std::string& path) : file_(path) {
+        ContractionHierarchyFileHeader header;
+        if (file_.Size() < sizeof(header)) {
+            throw std::runtime_error("contraction hierarchy file is too short: " + path);
+        }
+        std::memcpy(&header, file_.Data(), sizeof(header));
+        if (std::memcmp(header.magic, ContractionHierarchyFileHeader::kMagic,
+                        sizeof(header.magic)) != 0 ||
+            header.version != ContractionHierarchyFileHeader::kVersion) {
+            throw std::runtime_error("not a contraction hierarchy file: " + path);
+        }
+        size_t vertex_count = header.vertex_count;
+        FileSizeCounter expected_size(sizeof(header));
+        expected_size.Add(vertex_count, 8);
+        for (size_t edge_count : {header.upward_edge_count, header.backward_edge_count}) {
+            expected_size.Add(vertex_count, 8);
+            expected_size.Add(1, 8);
+            expected_size.Add(edge_count, 3 * 8);
+        }
+        if (!expected_size.Matches(file_.Size())) {
+            throw std::runtime_error("contraction hierarchy file is corrupted: " + path);
+        }
+
+        const size_t* data = reinterpret_cast<const size_t*>(file_.Data() + sizeof(header));
+        auto take = [&data](size_t count) {
+            const size_t* begin = data;
+            data += count;
+            return begin;
+        };
+        view_.vertex_count = vertex_count;
+        view_.ranks = take(vertex_count);
+        for (auto [edges, edge_count] : {std::make_pair(&view_.upward, header.upward_edge_count),
+                                         std::make_pair(&view_.backward, header.backward_edge_count)}) {
+            edges->offsets = take(vertex_count + 1);
+            edges->targets = take(edge_count);
+            edges->weights = reinterpret_cast<const Distance*>(take(edge_count));
+            edges->middles = take(edge_count);
+        }
+        if (!IsValidHierarchy(header)) {
+            throw std::runtime_error("contraction hierarchy file is corrupted: " + path);
+        }
+    }
+
+    ContractionHierarchyView GetView() const {
+        return view_;
+    }
+
+private:
+    MappedFile file_;
+    ContractionHierarchyView view_;
+
+    // ranks are a permutation, every edge goes to a higher rank, and a shortcut goes through
+    // a vertex of a lower rank than its ends by two edges which exist, so unpacking terminates
+    bool IsValidHierarchy(const ContractionHierarchyFileHeader& header) const {
+        size_t vertex_count = view_.vertex_count;
+        std::vector<bool> is_rank_used(vertex_count, false);
+        for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+            size_t rank = view_.ranks[vertex];
+            if (rank >= vertex_count || is_rank_used[rank]) {
+                return false;
+            }
+            is_rank_used[rank] = true;
+        }
+        for (const auto& [edges, edge_count] :
+             {std::make_pair(view_.upward, header.upward_edge_count),
+              std::make_pair(view_.backward, header.backward_edge_count)}) {
+            if (!IsValidCsr(vertex_count, edge_count, edges.offsets, edges.targets)) {
+                return false;
+            }
+        }
+        for (bool is_upward : {true, false}) {
+            const HierarchyEdgesView& edges = is_upward ? view_.upward : view_.backward;
+            for (Vertex vertex = 0; vertex < vertex_count; ++vertex) {
+                for (size_t edge = edges.offsets[vertex]; edge < edges.offsets[vertex + 1];
+                     ++edge) {
+                    Vertex target = edges.targets[edge];
+                    Vertex middle = edges.middles[edge];
+                    size_t rank = view_.ranks[vertex];
+                    if (view_.ranks[target] <= rank) {
+                        return false;
+                    }
+                    if (middle == kNoVertex) {
+                        continue;
+                    }
+                    Vertex from = is_upward ? vertex : target;
+                    Vertex to = is_upward ? target : vertex;
+                    if (middle >= vertex_count || view_.ranks[middle] >= rank ||
+                        !HasEdge(from, middle) || !HasEdge(middle, to)) {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    // looks for edge (from, to) where ContractionHierarchyQuery::FindMiddle does
+    bool HasEdge(Vertex from, Vertex to) const {
+        bool upward = view_.ranks[from] < view_.ranks[to];
+        const HierarchyEdgesView& edges = upward ? view_.upward : view_.backward;
+        Vertex row = upward ? from : to;
+        Vertex target = upward ? to : from;
+        return std::find(edges.targets + edges.offsets[row], edges.targets + edges.offsets[row + 1],
+                         target) != edges.targets + edges.offsets[row + 1];
+    }
+};
+
+class ContractionHierarchyQuery {
+public:
+    explicit ContractionHierarchyQuery(ContractionHierarchyView hierarchy)
+        : hierarchy_(hierarchy),
+          forward_(hierarchy.vertex_count, hierarchy.upward),
+          backward_(hierarchy.vertex_count, hierarchy.backward) {
+    }
+
+    ShortestPath Query(Vertex start_vertex, Vertex finish_vertex, bool restore_path = false) {
+        forward_.Start(start_vertex);
+        backward_.Start(finish_vertex);
+        Distance best_distance = kInfDistance;
+        Vertex meeting_vertex = kNoVertex;
+
+        // both searches only go up, each one stops when it can not improve the best distance
+        while (true) {
+            bool forward_active = forward_.CanImprove(best_distance);
+            bool backward_active = backward_.CanImprove(best_distance);
+            if (!forward_active && !backward_active) {
+                break;
+            }
+            SearchSide& side = forward_active &&
+                (!backward_active || forward_.GetMinDistance() <= backward_.GetMinDistance())
+                ? forward_ : backward_;
+            SearchSide& other = &side == &forward_ ? backward_ : forward_;
+            Vertex vertex = side.ProveMinVertex();
+            if (other.GetDistance(vertex) != kInfDistance) {
+                Distance distance = side.GetDistance(vertex) + other.GetDistance(vertex);
+                if (best_distance == kInfDistance || distance < best_distance) {
+                    best_distance = distance;
+                    meeting_vertex = vertex;
+                }
+            }
+        }
+
+        ShortestPath result{best_distance, {}};
+        if (restore_path && best_distance != kInfDistance) {
+            std::vector<Vertex> up_path;
+            for (Vertex vertex = meeting_vertex; vertex != kNoVertex;
+                 vertex = forward_.GetParent(vertex)) {
+                up_path.push_back(vertex);
+            }
+            std::reverse(up_path.begin(), up_path.end());
+            for (Vertex vertex = backward_.GetParent(meeting_vertex); vertex != kNoVertex;
+                 vertex = backward_.GetParent(vertex)) {
+                up_path.push_back(vertex);
+            }
+            result.path.push_back(start_vertex);
+            for (size_t index = 1; index < up_path.size(); ++index) {
+                UnpackEdge(up_path[index - 1], up_path[index], &result.path);
+            }
+        }
+        return result;
+    }
+
+private:
+    class SearchSide {
+    public:
+        SearchSide(size_t vertex_count, HierarchyEdgesView edges)
+            : edges_(edges),
+              distances_(vertex_count, kInfDistance),
+              parents_(vertex_count, kNoVertex) {
+        }
+
+        void Start(Vertex source) {
+            for (Vertex vertex : touched_) {
+                distances_[vertex] = kInfDistance;
+                parents_[vertex] = kNoVertex;
+            }
+            touched_.clear();
+            queue_ = {};
+            distances_[source] = 0;
+            touched_.push_back(source);
+            queue_.emplace(0, source);
+        }
+
+        bool CanImprove(Distance best_distance) {
+            SkipOutdated();
+            return !queue_.empty() &&
+                   (best_distance == kInfDistance || queue_.top().first < best_distance);
+        }
+
+        Distance GetMinDistance() {
+            SkipOutdated();
+            return queue_.top().first;
+        }
+
+        Vertex ProveMinVertex() {
+            SkipOutdated();
+            auto [distance, vertex] = queue_.top();
+            queue_.pop();
+            for (size_t edge = edges_.offsets[vertex]; edge < edges_.offsets[vertex + 1]; ++edge) {
+                Vertex to = edges_.targets[edge];
+                Distance new_distance = distance + edges_.weights[edge];
+                if (distances_[to] == kInfDistance) {
+                    touched_.push_back(to);
+                } else if (distances_[to] <= new_distance) {
+                    continue;
+                }
+                distances_[to] = new_distance;
+                parents_[to] = vertex;
+                queue_.emplace(new_distance, to);
+            }
+            return vertex;
+        }
+
+        Distance GetDistance(Vertex vertex) const {
+            return distances_[vertex];
+        }
+
+        Vertex GetParent(Vertex vertex) const {
+            return parents_[vertex];
+        }
+
+    private:
+        using Entry = std::pair<Distance, Vertex>;
+
+        HierarchyEdgesView edges_;
+        std::vector<Distance> distances_;
+        std::vector<Vertex> parents_;
+        std::vector<Vertex> touched_;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<>> queue_;
+
+        void SkipOutdated() {
+            while (!queue_.empty() && queue_.top().first != distances_[queue_.top().second]) {
+                queue_.pop();
+            }
+        }
+    };
+
+    ContractionHierarchyView hierarchy_;
+    SearchSide forward_;
+    SearchSide backward_;
+
+    Vertex FindMiddle(Vertex from, Vertex to) const {
+        bool upward = hierarchy_.ranks[from] < hierarchy_.ranks[to];
+        const HierarchyEdgesView& edges = upward ? hierarchy_.upward : hierarchy_.backward;
+        Vertex row = upward ? from : to;
+        Vertex target = upward ? to : from;
+        for (size_t edge = edges.offsets[row]; edge < edges.offsets[row + 1]; ++edge) {
+            if (edges.targets[edge] == target) {
+                return edges.middles[edge];
+            }
+        }
+        assert(false);
+        return kNoVertex;
+    }
+
+    // appends the original vertexes of edge (from, to) except @from
+    void UnpackEdge(Vertex from, Vertex to, std::vector<Vertex>* path) const {
+        std::vector<std::pair<Vertex, Vertex>> stack = {{from, to}};
+        while (!stack.empty()) {
+            auto [edge_from, edge_to] = stack.back();
+            stack.pop_back();
+            Vertex middle = FindMiddle(edge_from, edge_to);
+            if (middle == kNoVertex) {
+                path->push_back(edge_to);
+            } else {
+                stack.emplace_back(middle, edge_to);
+                stack.emplace_back(edge_from, middle);
+            }
+        }
+    }
+};
+
+}  // namespace dijkstra
@@ -0,0 +1,280 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <type_traits>
+#include <cstddef>
+#include <cassert>
+
+// INTERFACE
+
+// Compressed sparse row graph: outgoing edges of vertex v are
+// [offsets[v], offsets[v + 1]) in targets (and weights, if Weight is not void).
+// Iterating graph[v] yields `to` for unweighted graphs and `std::pair{to, weight}` otherwise,
+// so the same algorithm code runs on CSR and on adjacency-list graphs.
+template <class Weight = void>
+class CsrGraph;
+
+template <class Weight>
+class CsrGraphView;
+
+template <class Weight>
+struct CsrEdge {
+    size_t from;
+    size_t to;
+    Weight weight;
+};
+
+CsrGraph<> MakeCsrGraph(size_t vertex_count, const std::vector<std::pair<size_t, size_t>>& edges);
+
+template <class Weight>
+CsrGraph<Weight> MakeCsrGraph(size_t vertex_count, const std::vector<CsrEdge<Weight>>& edges);
+
+// checks arrays which come from outside, e.g. from a mapped file, in one pass: offsets go from 0
+// to @edge_count and never decrease, targets are vertexes
+bool IsValidCsr(size_t vertex_count, size_t edge_count, const size_t* offsets,
+                const size_t* targets);
+
+// IMPLEMENTATION
+
+template <class Weight>
+using CsrStoredWeight = std::conditional_t<std::is_void_v<Weight>, char, Weight>;
+
+// edges [begin, end) of one vertex
+template <class Weight>
+class CsrEdgeRange {
+public:
+    class Iterator {
+    public:
+        Iterator(const size_t* target, const CsrStoredWeight<Weight>* weight)
+            : target_(target), weight_(weight) {
+        }
+
+        auto operator*() const {
+            if constexpr (std::is_void_v<Weight>) {
+                return *target_;
+            } else {
+                return std::pair<size_t, Weight>(*target_, *weight_);
+            }
+        }
+
+        Iterator& operator++() {
+            ++target_;
+            if constexpr (!std::is_void_v<Weight>) {
+                ++weight_;
+            }
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return target_ == other.target_;
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return target_ != other.target_;
+        }
+
+    private:
+        const size_t* target_;
+        const CsrStoredWeight<Weight>* weight_;
+    };
+
+    CsrEdgeRange(const size_t* targets_begin, const size_t* targets_end,
+                 const CsrStoredWeight<Weight>* weights_begin)
+        : targets_begin_(targets_begin), targets_end_(targets_end), weights_begin_(weights_begin) {
+    }
+
+    Iterator begin() const {
+        return {targets_begin_, weights_begin_};
+    }
+
+    Iterator end() const {
+        return {targets_end_, nullptr};
+    }
+
+    size_t size() const {
+        return targets_end_ - targets_begin_;
+    }
+
+    bool empty() const {
+        return targets_begin_ == targets_end_;
+    }
+
+private:
+    const size_t* targets_begin_;
+    const size_t* targets_end_;
+    const CsrStoredWeight<Weight>* weights_begin_;
+};
+
+// Non-owning CSR graph over arrays which live elsewhere, e.g. in a CsrGraph or a mapped file.
+template <class Weight = void>
+class CsrGraphView {
+public:
+    CsrGraphView(size_t vertex_count, const size_t* offsets, const size_t* targets,
+                 const CsrStoredWeight<Weight>* weights = nullptr)
+        : vertex_count_(vertex_count), offsets_(offsets), targets_(targets), weights_(weights) {
+    }
+
+    size_t size() const {
+        return vertex_count_;
+    }
+
+    size_t EdgeCount() const {
+        return offsets_[vertex_count_];
+    }
+
+    CsrEdgeRange<Weight> operator[](size_t vertex) const {
+        return {targets_ + offsets_[vertex], targets_ + offsets_[vertex + 1],
+                std::is_void_v<Weight> ? nullptr : weights_ + offsets_[vertex]};
+    }
+
+    size_t GetEdgeBegin(size_t vertex) const {
+        return offsets_[vertex];
+    }
+
+    size_t GetEdgeEnd(size_t vertex) const {
+        return offsets_[vertex + 1];
+    }
+
+    size_t GetTarget(size_t edge) const {
+        return targets_[edge];
+    }
+
+    template <class W = Weight, class = std::enable_if_t<!std::is_void_v<W>>>
+    W GetWeight(size_t edge) const {
+        return weights_[edge];
+    }
+
+private:
+    size_t vertex_count_;
+    const size_t* offsets_;
+    const size_t* targets_;
+    const CsrStoredWeight<Weight>* weights_;
+};
+
+template <class Weight>
+class CsrGraph {
+private:
+    static constexpr bool kWeighted = !std::is_void_v<Weight>;
+    using StoredWeight = CsrStoredWeight<Weight>;
+
+public:
+    CsrGraph() : offsets_(1, 0) {
+    }
+
+    CsrGraph(std::vector<size_t> offsets, std::vector<size_t> targets,
+             std::vector<StoredWeight> weights = {})
+        : offsets_(std::move(offsets)), targets_(std::move(targets)), weights_(std::move(weights)) {
+        assert(!offsets_.empty() && offsets_.back() == targets_.size());
+        assert(!kWeighted || weights_.size() == targets_.size());
+    }
+
+    CsrGraphView<Weight> GetView() const {
+        return {size(), offsets_.data(), targets_.data(), weights_.data()};
+    }
+
+    size_t size() const {
+        return offsets_.size() - 1;
+    }
+
+    size_t EdgeCount() const {
+        return targets_.size();
+    }
+
+    CsrEdgeRange<Weight> operator[](size_t vertex) const {
+        return GetView()[vertex];
+    }
+
+    size_t GetEdgeBegin(size_t vertex) const {
+        return offsets_[vertex];
+    }
+
+    size_t GetEdgeEnd(size_t vertex) const {
+        return offsets_[vertex + 1];
+    }
+
+    size_t GetTarget(size_t edge) const {
+        return targets_[edge];
+    }
+
+    template <class W = Weight, class = std::enable_if_t<!std::is_void_v<W>>>
+    W GetWeight(size_t edge) const {
+        return weights_[edge];
+    }
+
+    const std::vector<size_t>& GetOffsets() const {
+        return offsets_;
+    }
+
+    const std::vector<size_t>& GetTargets() const {
+        return targets_;
+    }
+
+    const std::vector<StoredWeight>& GetWeights() const {
+        return weights_;
+    }
+
+private:
+    std::vector<size_t> offsets_;
+    std::vector<size_t> targets_;
+    std::vector<StoredWeight> weights_;
+};
+
+// counting sort by source vertex, keeps the input order of edges inside each row
+CsrGraph<> MakeCsrGraph(size_t vertex_count, const std::vector<std::pair<size_t, size_t>>& edges) {
+    std::vector<size_t> offsets(vertex_count + 1, 0);
+    for (const auto& [from, to] : edges) {
+        assert(from < vertex_count && to < vertex_count);
+        ++offsets[from + 1];
+    }
+    for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+        offsets[vertex + 1] += offsets[vertex];
+    }
+
+    std::vector<size_t> positions(offsets.begin(), offsets.end() - 1);
+    std::vector<size_t> targets(edges.size());
+    for (const auto& [from, to] : edges) {
+        targets[positions[from]++] = to;
+    }
+    return {std::move(offsets), std::move(targets)};
+}
+
+template <class Weight>
+CsrGraph<Weight> MakeCsrGraph(size_t vertex_count, const std::vector<CsrEdge<Weight>>& edges) {
+    std::vector<size_t> offsets(vertex_count + 1, 0);
+    for (const CsrEdge<Weight>& edge : edges) {
+        assert(edge.from < vertex_count && edge.to < vertex_count);
+        ++offsets[edge.from + 1];
+    }
+    for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+        offsets[vertex + 1] += offsets[vertex];
+    }
+
+    std::vector<size_t> positions(offsets.begin(), offsets.end() - 1);
+    std::vector<size_t> targets(edges.size());
+    std::vector<Weight> weights(edges.size());
+    for (const CsrEdge<Weight>& edge : edges) {
+        size_t position = positions[edge.from]++;
+        targets[position] = edge.to;
+        weights[position] = edge.weight;
+    }
+    return {std::move(offsets), std::move(targets), std::move(weights)};
+}
+
+bool IsValidCsr(size_t vertex_count, size_t edge_count, const size_t* offsets,
+                const size_t* targets) {
+    if (offsets[0] != 0 || offsets[vertex_count] != edge_count) {
+        return false;
+    }
+    for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+        if (offsets[vertex] > offsets[vertex + 1]) {
+            return false;
+        }
+    }
+    for (size_t edge = 0; edge < edge_count; ++edge) {
+        if (targets[edge] >= vertex_count) {
+            return false;
+        }
+    }
+    return true;
+}
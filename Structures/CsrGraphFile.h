@@ -0,0 +1,185 @@
+#pragma once
+
+#include <string>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+#include <stdexcept>
+
+#include "CsrGraph.h"
+#include "../Utils/mapped_file.h"
+
+// INTERFACE
+
+// Binary CSR format, all values in native byte order:
+//   CsrFileHeader (48 bytes)
+//   offsets: (vertex_count + 1) x uint64
+//   targets: edge_count x uint64
+//   weights: edge_count x weight_size bytes, zero-padded to a multiple of 8, if weight_size != 0
+// A file with weights can be mapped as an unweighted graph, the weights are ignored then.
+struct CsrFileHeader;
+
+template <class Weight>
+void SaveCsrGraph(const CsrGraphView<Weight>& graph, const std::string& path);
+
+template <class Weight>
+void SaveCsrGraph(const CsrGraph<Weight>& graph, const std::string& path);
+
+// read-only graph backed by mmap of a file written by SaveCsrGraph, loading does not copy
+// the arrays but checks offsets and targets in one pass; throws std::runtime_error if the file
+// is malformed or its weight type differs
+template <class Weight = void>
+class MappedCsrGraph;
+
+// IMPLEMENTATION
+
+struct CsrFileHeader {
+    static constexpr char kMagic[8] = {'A', 'L', 'G', 'O', '-', 'C', 'S', 'R'};
+    static constexpr uint64_t kVersion = 1;
+
+    enum WeightKind : uint32_t {
+        kNoWeight = 0,
+        kSignedInteger = 1,
+        kUnsignedInteger = 2,
+        kFloatingPoint = 3,
+    };
+
+    char magic[8];
+    uint64_t version;
+    uint64_t vertex_count;
+    uint64_t edge_count;
+    uint32_t weight_kind;
+    uint32_t weight_size;
+    uint64_t reserved;
+};
+
+static_assert(sizeof(CsrFileHeader) == 48 && sizeof(size_t) == 8);
+
+template <class Weight>
+constexpr uint32_t GetCsrWeightKind() {
+    if constexpr (std::is_void_v<Weight>) {
+        return CsrFileHeader::kNoWeight;
+    } else if constexpr (std::is_floating_point_v<Weight>) {
+        return CsrFileHeader::kFloatingPoint;
+    } else {
+        static_assert(std::is_integral_v<Weight>);
+        return std::is_signed_v<Weight> ? CsrFileHeader::kSignedInteger
+                                        : CsrFileHeader::kUnsignedInteger;
+    }
+}
+
+template <class Weight>
+constexpr uint32_t GetCsrWeightSize() {
+    if constexpr (std::is_void_v<Weight>) {
+        return 0;
+    } else {
+        return sizeof(Weight);
+    }
+}
+
+size_t GetCsrPaddedSize(size_t size) {
+    return (size + 7) / 8 * 8;
+}
+
+template <class Weight>
+void SaveCsrGraph(const CsrGraphView<Weight>& graph, const std::string& path) {
+    CsrFileHeader header;
+    std::memcpy(header.magic, CsrFileHeader::kMagic, sizeof(header.magic));
+    header.version = CsrFileHeader::kVersion;
+    header.vertex_count = graph.size();
+    header.edge_count = graph.EdgeCount();
+    header.weight_kind = GetCsrWeightKind<Weight>();
+    header.weight_size = GetCsrWeightSize<Weight>();
+    header.reserved = 0;
+
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (size_t vertex = 0; vertex <= graph.size(); ++vertex) {
+        uint64_t offset = vertex < graph.size() ? graph.GetEdgeBegin(vertex) : graph.EdgeCount();
+        out.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+    }
+    for (size_t edge = 0; edge < graph.EdgeCount(); ++edge) {
+        uint64_t target = graph.GetTarget(edge);
+        out.write(reinterpret_cast<const char*>(&target), sizeof(target));
+    }
+    if constexpr (!std::is_void_v<Weight>) {
+        for (size_t edge = 0; edge < graph.EdgeCount(); ++edge) {
+            Weight weight = graph.GetWeight(edge);
+            out.write(reinterpret_cast<const char*>(&weight), sizeof(weight));
+        }
+        size_t weights_size = graph.EdgeCount() * sizeof(Weight);
+        static constexpr char kPadding[8] = {};
+        out.write(kPadding, GetCsrPaddedSize(weights_size) - weights_size);
+    }
+    if (!out) {
+        throw std::runtime_error("can not write " + path);
+    }
+}
+
+template <class Weight>
+void SaveCsrGraph(const CsrGraph<Weight>& graph, const std::string& path) {
+    SaveCsrGraph(graph.GetView(), path);
+}
+
+template <class Weight>
+class MappedCsrGraph {
+public:
+    explicit MappedCsrGraph(const std::string& path) : file_(path), view_(0, &kEmptyOffset, nullptr) {
+        CsrFileHeader header;
+        if (file_.Size() < sizeof(header)) {
+            throw std::runtime_error("csr graph file is too short: " + path);
+        }
+        std::memcpy(&header, file_.Data(), sizeof(header));
+        if (std::memcmp(header.magic, CsrFileHeader::kMagic, sizeof(header.magic)) != 0 ||
+            header.version != CsrFileHeader::kVersion) {
+            throw std::runtime_error("not a csr graph file: " + path);
+        }
+        if (!std::is_void_v<Weight> && (header.weight_kind != GetCsrWeightKind<Weight>() ||
+                                        header.weight_size != GetCsrWeightSize<Weight>())) {
+            throw std::runtime_error("csr graph file has another weight type: " + path);
+        }
+        FileSizeCounter expected_size(sizeof(header));
+        expected_size.Add(header.vertex_count, 8);
+        expected_size.Add(1, 8);
+        expected_size.Add(header.edge_count, 8);
+        expected_size.Add(header.edge_count, header.weight_size);
+        expected_size.Align(8);
+        if (!expected_size.Matches(file_.Size())) {
+            throw std::runtime_error("csr graph file is corrupted: " + path);
+        }
+
+        const char* data = file_.Data() + sizeof(header);
+        const size_t* offsets = reinterpret_cast<const size_t*>(data);
+        const size_t* targets = offsets + header.vertex_count + 1;
+        const auto* weights = reinterpret_cast<const CsrStoredWeight<Weight>*>(
+            targets + header.edge_count);
+        if (!IsValidCsr(header.vertex_count, header.edge_count, offsets, targets)) {
+            throw std::runtime_error("csr graph file is corrupted: " + path);
+        }
+        view_ = CsrGraphView<Weight>(header.vertex_count, offsets, targets,
+                                     std::is_void_v<Weight> ? nullptr : weights);
+    }
+
+    const CsrGraphView<Weight>& GetView() const {
+        return view_;
+    }
+
+    size_t size() const {
+        return view_.size();
+    }
+
+    size_t EdgeCount() const {
+        return view_.EdgeCount();
+    }
+
+    CsrEdgeRange<Weight> operator[](size_t vertex) const {
+        return view_[vertex];
+    }
+
+private:
+    static constexpr size_t kEmptyOffset = 0;
+
+    MappedFile file_;
+    CsrGraphView<Weight> view_;
+};
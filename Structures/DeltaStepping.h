@@ -0,0 +1,181 @@
+#pragma once
+
+#include <vector>
+#include <map>
+#include <atomic>
+#include <limits>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#include <cassert>
+
+#include "CsrGraph.h"
+#include "Dijkstra.h"
+#include "../Utils/thread_pool.h"
+
+// INTERFACE
+
+namespace dijkstra {
+
+// Parallel single source shortest paths, returns exactly what Dijkstra(graph, start_vertex) does.
+// Vertexes are processed in buckets of width @delta: edges not heavier than @delta are relaxed
+// until the current bucket is empty, heavier ones once per bucket. Weights must be non-negative,
+// the average edge weight is a reasonable first guess for @delta. Throws std::invalid_argument
+// if @delta is not positive.
+std::vector<Distance> DeltaStepping(const Graph& graph, Vertex start_vertex, Distance delta,
+                                    size_t thread_count = std::thread::hardware_concurrency());
+
+std::vector<Distance> DeltaStepping(const CsrGraph<Distance>& graph, Vertex start_vertex,
+                                    Distance delta,
+                                    size_t thread_count = std::thread::hardware_concurrency());
+
+// IMPLEMENTATION
+
+template <class GraphType>
+class DeltaSteppingFinder {
+public:
+    DeltaSteppingFinder(const GraphType& graph, Distance delta, size_t thread_count)
+        : graph_(graph),
+          delta_(delta),
+          thread_pool_(thread_count),
+          distances_(graph.size()),
+          round_marks_(graph.size(), 0),
+          bucket_marks_(graph.size(), 0),
+          updated_vertexes_(thread_pool_.Size()) {
+        if (delta_ <= 0) {
+            throw std::invalid_argument("delta stepping needs a positive delta");
+        }
+        for (auto& distance : distances_) {
+            distance.store(kUnreached, std::memory_order_relaxed);
+        }
+    }
+
+    std::vector<Distance> Find(Vertex start_vertex) {
+        distances_[start_vertex].store(0, std::memory_order_relaxed);
+        buckets_[0].push_back(start_vertex);
+
+        while (!buckets_.empty()) {
+            Distance bucket_index = buckets_.begin()->first;
+            std::vector<Vertex> bucket = std::move(buckets_.begin()->second);
+            buckets_.erase(buckets_.begin());
+            ++bucket_mark_;
+            proved_.clear();
+
+            while (!bucket.empty()) {
+                ++round_mark_;
+                frontier_.clear();
+                for (Vertex vertex : bucket) {
+                    if (GetBucket(vertex) != bucket_index || round_marks_[vertex] == round_mark_) {
+                        continue;
+                    }
+                    round_marks_[vertex] = round_mark_;
+                    frontier_.push_back(vertex);
+                    if (bucket_marks_[vertex] != bucket_mark_) {
+                        bucket_marks_[vertex] = bucket_mark_;
+                        proved_.push_back(vertex);
+                    }
+                }
+                RelaxEdges(frontier_, true);
+                bucket.clear();
+                MoveUpdatedToBuckets(bucket_index, &bucket);
+            }
+
+            RelaxEdges(proved_, false);
+            MoveUpdatedToBuckets(bucket_index, nullptr);
+        }
+
+        std::vector<Distance> result(graph_.size());
+        for (Vertex vertex = 0; vertex < graph_.size(); ++vertex) {
+            Distance distance = distances_[vertex].load(std::memory_order_relaxed);
+            result[vertex] = distance == kUnreached ? kInfDistance : distance;
+        }
+        return result;
+    }
+
+private:
+    static constexpr Distance kUnreached = std::numeric_limits<Distance>::max();
+    static constexpr size_t kChunkSize = 256;
+
+    const GraphType& graph_;
+    Distance delta_;
+    ThreadPool thread_pool_;
+    std::vector<std::atomic<Distance>> distances_;
+    std::map<Distance, std::vector<Vertex>> buckets_;
+
+    // marks avoid processing a vertex twice inside one relaxation round or one bucket
+    uint64_t round_mark_ = 0;
+    uint64_t bucket_mark_ = 0;
+    std::vector<uint64_t> round_marks_;
+    std::vector<uint64_t> bucket_marks_;
+
+    std::vector<Vertex> frontier_;
+    std::vector<Vertex> proved_;
+    std::vector<std::vector<Vertex>> updated_vertexes_;
+
+    Distance GetBucket(Vertex vertex) const {
+        return distances_[vertex].load(std::memory_order_relaxed) / delta_;
+    }
+
+    void RelaxEdges(const std::vector<Vertex>& vertexes, bool light) {
+        std::atomic<size_t> next_chunk{0};
+        thread_pool_.Run([&](size_t thread_index) {
+            std::vector<Vertex>& updated = updated_vertexes_[thread_index];
+            size_t begin;
+            while ((begin = next_chunk.fetch_add(kChunkSize)) < vertexes.size()) {
+                size_t end = std::min(begin + kChunkSize, vertexes.size());
+                for (size_t index = begin; index < end; ++index) {
+                    Vertex vertex = vertexes[index];
+                    Distance distance = distances_[vertex].load(std::memory_order_relaxed);
+                    for (const auto& [target_vertex, weight] : graph_[vertex]) {
+                        assert(weight >= 0);
+                        if ((weight <= delta_) != light) {
+                            continue;
+                        }
+                        if (Relax(target_vertex, distance + weight)) {
+                            updated.push_back(target_vertex);
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+    bool Relax(Vertex vertex, Distance new_distance) {
+        Distance current = distances_[vertex].load(std::memory_order_relaxed);
+        while (new_distance < current) {
+            if (distances_[vertex].compare_exchange_weak(current, new_distance,
+                                                         std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // vertexes which stay in the current bucket go to @current_bucket
+    void MoveUpdatedToBuckets(Distance current_bucket_index, std::vector<Vertex>* current_bucket) {
+        for (std::vector<Vertex>& updated : updated_vertexes_) {
+            for (Vertex vertex : updated) {
+                Distance bucket_index = GetBucket(vertex);
+                if (bucket_index == current_bucket_index) {
+                    assert(current_bucket);
+                    current_bucket->push_back(vertex);
+                } else {
+                    buckets_[bucket_index].push_back(vertex);
+                }
+            }
+            updated.clear();
+        }
+    }
+};
+
+std::vector<Distance> DeltaStepping(const Graph& graph, Vertex start_vertex, Distance delta,
+                                    size_t thread_count) {
+    return DeltaSteppingFinder(graph, delta, thread_count).Find(start_vertex);
+}
+
+std::vector<Distance> DeltaStepping(const CsrGraph<Distance>& graph, Vertex start_vertex,
+                                    Distance delta, size_t thread_count) {
+    return DeltaSteppingFinder(graph, delta, thread_count).Find(start_vertex);
+}
+
+}  // namespace dijkstra
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <cassert>
+
+#include "CsrGraph.h"
+#include "Dijkstra.h"
+
+// INTERFACE
+
+namespace dijkstra {
+
+// Dijkstra bound to one graph for many queries. Distance, parent and heap position arrays
+// are allocated once; every vertex carries the number of the query which last touched it,
+// so starting a new query costs O(1) instead of refilling O(V) arrays.
+template <class GraphType>
+class DijkstraEngine;
+
+// IMPLEMENTATION
+
+template <class GraphType>
+class DijkstraEngine {
+public:
+    explicit DijkstraEngine(const GraphType& graph)
+        : graph_(graph),
+          generations_(graph.size(), 0),
+          distances_(graph.size()),
+          parents_(graph.size()),
+          heap_(graph.size()) {
+    }
+
+    // proves all vertexes reachable from @source
+    void Query(Vertex source) {
+        Run(source, kNoVertex);
+    }
+
+    // stops as soon as @target is proved, returns kInfDistance if it is unreachable
+    Distance Query(Vertex source, Vertex target) {
+        Run(source, target);
+        return GetDistance(target);
+    }
+
+    // results of the last query; vertexes which were not proved have kInfDistance
+    Distance GetDistance(Vertex vertex) const {
+        return IsProved(vertex) ? distances_[vertex] : kInfDistance;
+    }
+
+    Vertex GetParent(Vertex vertex) const {
+        return IsProved(vertex) ? parents_[vertex] : kNoVertex;
+    }
+
+    // [source, ..., target], empty if target was not proved by the last query
+    std::vector<Vertex> GetPath(Vertex target) const {
+        std::vector<Vertex> path;
+        if (!IsProved(target)) {
+            return path;
+        }
+        for (Vertex vertex = target; vertex != kNoVertex; vertex = parents_[vertex]) {
+            path.push_back(vertex);
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    std::vector<Distance> GetDistances() const {
+        std::vector<Distance> distances(graph_.size());
+        WriteDistances(distances.data());
+        return distances;
+    }
+
+    // writes graph.size() distances of the last query to @output
+    void WriteDistances(Distance* output) const {
+        for (Vertex vertex = 0; vertex < graph_.size(); ++vertex) {
+            output[vertex] = GetDistance(vertex);
+        }
+    }
+
+    // number of vertexes touched by the last query
+    size_t GetTouchedCount() const {
+        return touched_count_;
+    }
+
+private:
+    const GraphType& graph_;
+    uint32_t generation_ = 0;
+    std::vector<uint32_t> generations_;
+    std::vector<Distance> distances_;
+    std::vector<Vertex> parents_;
+    // holds heap positions; it is left empty by every query, or cleared in O(its size)
+    DijkstraHeap heap_;
+    size_t touched_count_ = 0;
+
+    bool IsTouched(Vertex vertex) const {
+        return generations_[vertex] == generation_;
+    }
+
+    bool IsProved(Vertex vertex) const {
+        return IsTouched(vertex) && !heap_.Contains(vertex);
+    }
+
+    void StartQuery() {
+        heap_.Clear();
+        touched_count_ = 0;
+        if (++generation_ == 0) {
+            std::fill(generations_.begin(), generations_.end(), 0);
+            generation_ = 1;
+        }
+    }
+
+    void Run(Vertex source, Vertex target) {
+        StartQuery();
+        Reach(source, 0, kNoVertex);
+        while (!heap_.Empty()) {
+            Vertex vertex = heap_.Top();
+            heap_.Pop();
+            if (vertex == target) {
+                break;
+            }
+            for (const auto& [target_vertex, weight] : graph_[vertex]) {
+                Distance new_distance = distances_[vertex] + weight;
+                if (!IsTouched(target_vertex)) {
+                    Reach(target_vertex, new_distance, vertex);
+                } else if (heap_.Contains(target_vertex) &&
+                           new_distance < distances_[target_vertex]) {
+                    distances_[target_vertex] = new_distance;
+                    parents_[target_vertex] = vertex;
+                    heap_.DecreaseKey(target_vertex, new_distance);
+                }
+            }
+        }
+    }
+
+    void Reach(Vertex vertex, Distance distance, Vertex parent) {
+        generations_[vertex] = generation_;
+        distances_[vertex] = distance;
+        parents_[vertex] = parent;
+        heap_.Push(vertex, distance);
+        ++touched_count_;
+    }
+};
+
+}  // namespace dijkstra
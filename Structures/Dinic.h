@@ -1,19 +1,55 @@
 #pragma once
 
+#include <iostream>
 #include <vector>
 #include <unordered_map>
-#include <queue>
+#include <utility>
 #include <algorithm>
+#include <limits>
+#include <cstdint>
 #include <cassert>
 
+#include "CsrGraph.h"
+#include "MaxFlowStats.h"
+
 // INTERFACE
+
+namespace dinic {
+
 using Capacity = int64_t;
 
 using Graph = std::vector<std::unordered_map<size_t, Capacity>>;
 
 Graph MakeResidualNetwork(const Graph& graph);
 
-Capacity FindMaxFlowDinic(size_t source, size_t target, const Graph& graph);
+// parallel edges are merged, their capacities are summed up
+Graph MakeResidualNetwork(const CsrGraph<Capacity>& graph);
+
+Graph MakeResidualNetwork(const CsrGraphView<Capacity>& graph);
+
+// Flat residual network, edge e is paired with its reverse e ^ 1
+class FlowNetwork;
+
+// antiparallel edges of @graph share one edge pair, self-loops are dropped
+FlowNetwork MakeFlowNetwork(const Graph& graph);
+
+// every edge gets its own pair, so parallel edges stay separate
+FlowNetwork MakeFlowNetwork(const CsrGraphView<Capacity>& graph);
+
+// Dinic with level graph, current-arc pointers and an iterative blocking flow search,
+// the flow is left in the network; MaxFlowStats as @Stats collects counters and timings
+template <class Stats = NoMaxFlowStats>
+class MaxFlowDinicFinder;
+
+// @capacity_scaling augments along wide paths first, worth it when capacities vary a lot
+Capacity FindMaxFlowDinic(size_t source, size_t target, const Graph& graph,
+                          bool capacity_scaling = false);
+
+Capacity FindMaxFlowDinic(size_t source, size_t target, const CsrGraph<Capacity>& graph,
+                          bool capacity_scaling = false);
+
+Capacity FindMaxFlowDinic(size_t source, size_t target, const CsrGraphView<Capacity>& graph,
+                          bool capacity_scaling = false);
 
 Capacity FindMaxFlowDinicForResidualNetwork(size_t source, size_t target, Graph* residual_network);
 
@@ -53,168 +89,412 @@ Graph MakeResidualNetwork(const Graph& graph) {
     return residual_network;
 }
 
-std::vector<int> MakeLevels(const Graph& graph, size_t source) {
-    size_t vertex_count = graph.size();
-    std::vector<int> levels(vertex_count, -2);
+Graph MakeResidualNetwork(const CsrGraph<Capacity>& graph) {
+    return MakeResidualNetwork(graph.GetView());
+}
 
-    std::queue<size_t> vertex_queue;
-    std::vector<bool> used(vertex_count);
-    std::vector<size_t> found_by(vertex_count);
+Graph MakeResidualNetwork(const CsrGraphView<Capacity>& graph) {
+    Graph residual_network(graph.size());
+    for (size_t from = 0; from < graph.size(); ++from) {
+        for (const auto& [to, capacity] : graph[from]) {
+            residual_network[from][to] += capacity;
+            residual_network[to].emplace(from, 0);
+        }
+    }
+    return residual_network;
+}
+
+// Residual network in flat arrays: edge e and its reverse e ^ 1 are stored next to each other,
+// outgoing edges of every vertex are indexed in CSR form, rebuilt only after new edges appear.
+class FlowNetwork {
+public:
+    explicit FlowNetwork(size_t vertex_count = 0) : vertex_count_(vertex_count) {
+    }
 
-    vertex_queue.push(source);
-    used[source] = true;
-    found_by[source] = source;
-    levels[source] = -1;
+    // adds from -> to and its reverse to -> from, returns the id of the first one
+    size_t AddEdge(size_t from, size_t to, Capacity capacity, Capacity reverse_capacity = 0) {
+        assert(from < vertex_count_ && to < vertex_count_);
+        size_t edge = targets_.size();
+        targets_.push_back(to);
+        targets_.push_back(from);
+        capacities_.push_back(capacity);
+        capacities_.push_back(reverse_capacity);
+        initial_capacities_.push_back(capacity);
+        initial_capacities_.push_back(reverse_capacity);
+        return edge;
+    }
 
-    while (!vertex_queue.empty()) {
-        size_t vertex = vertex_queue.front();
-        vertex_queue.pop();
+    size_t VertexCount() const {
+        return vertex_count_;
+    }
 
-        levels[vertex] = levels[found_by[vertex]] + 1;
+    // including reverse edges
+    size_t EdgeCount() const {
+        return targets_.size();
+    }
+
+    size_t GetFrom(size_t edge) const {
+        return targets_[edge ^ 1];
+    }
+
+    size_t GetTo(size_t edge) const {
+        return targets_[edge];
+    }
+
+    // residual capacity
+    Capacity GetCapacity(size_t edge) const {
+        return capacities_[edge];
+    }
 
-        for (const auto& [neighbour, capacity] : graph[vertex]) {
-            if (used[neighbour] || capacity == 0) {
+    void SetCapacity(size_t edge, Capacity capacity) {
+        capacities_[edge] = capacity;
+    }
+
+    Capacity GetInitialCapacity(size_t edge) const {
+        return initial_capacities_[edge];
+    }
+
+    // keeps the flow, so the residual capacity becomes negative if it exceeds @capacity
+    void SetInitialCapacity(size_t edge, Capacity capacity) {
+        capacities_[edge] += capacity - initial_capacities_[edge];
+        initial_capacities_[edge] = capacity;
+    }
+
+    // flow through the edge, negative if the flow goes through its reverse
+    Capacity GetFlow(size_t edge) const {
+        return initial_capacities_[edge] - capacities_[edge];
+    }
+
+    void Push(size_t edge, Capacity flow) {
+        capacities_[edge] -= flow;
+        capacities_[edge ^ 1] += flow;
+    }
+
+    void ResetFlow() {
+        capacities_ = initial_capacities_;
+    }
+
+    // ids of edges leaving @vertex are GetAdjacentEdges()[GetAdjacencyBegin(vertex), ...End)
+    size_t GetAdjacencyBegin(size_t vertex) const {
+        return adjacency_offsets_[vertex];
+    }
+
+    size_t GetAdjacencyEnd(size_t vertex) const {
+        return adjacency_offsets_[vertex + 1];
+    }
+
+    const std::vector<size_t>& GetAdjacentEdges() const {
+        return adjacent_edges_;
+    }
+
+    void PrepareAdjacency() {
+        if (adjacent_edges_.size() == targets_.size() && !adjacency_offsets_.empty()) {
+            return;
+        }
+        adjacency_offsets_.assign(vertex_count_ + 1, 0);
+        for (size_t edge = 0; edge < targets_.size(); ++edge) {
+            ++adjacency_offsets_[GetFrom(edge) + 1];
+        }
+        for (size_t vertex = 0; vertex < vertex_count_; ++vertex) {
+            adjacency_offsets_[vertex + 1] += adjacency_offsets_[vertex];
+        }
+        std::vector<size_t> positions(adjacency_offsets_.begin(), adjacency_offsets_.end() - 1);
+        adjacent_edges_.resize(targets_.size());
+        for (size_t edge = 0; edge < targets_.size(); ++edge) {
+            adjacent_edges_[positions[GetFrom(edge)]++] = edge;
+        }
+    }
+
+private:
+    size_t vertex_count_;
+    std::vector<size_t> targets_;
+    std::vector<Capacity> capacities_;
+    std::vector<Capacity> initial_capacities_;
+    std::vector<size_t> adjacency_offsets_;
+    std::vector<size_t> adjacent_edges_;
+};
+
+// opposite edges of @graph share one pair, so every residual entry maps to exactly one edge
+FlowNetwork MakeFlowNetwork(const Graph& graph) {
+    FlowNetwork network(graph.size());
+    for (size_t from = 0; from < graph.size(); ++from) {
+        for (const auto& [to, capacity] : graph[from]) {
+            if (from == to) {
                 continue;
             }
-            used[neighbour] = true;
-            found_by[neighbour] = vertex;
-            vertex_queue.push(neighbour);
+            auto reverse = graph[to].find(from);
+            if (reverse == graph[to].end()) {
+                network.AddEdge(from, to, capacity);
+            } else if (from < to) {
+                network.AddEdge(from, to, capacity, reverse->second);
+            }
         }
     }
-
-    return levels;
+    return network;
 }
 
-Graph MakeLayeredNetwork(const Graph& graph, size_t source) {
-    std::vector<int> levels = MakeLevels(graph, source);
-
-    Graph layered_network(graph.size());
+FlowNetwork MakeFlowNetwork(const CsrGraphView<Capacity>& graph) {
+    FlowNetwork network(graph.size());
     for (size_t from = 0; from < graph.size(); ++from) {
         for (const auto& [to, capacity] : graph[from]) {
-            if (levels[from] + 1 == levels[to]) {
-                layered_network[from][to] = capacity;
+            if (from != to) {
+                network.AddEdge(from, to, capacity);
             }
         }
     }
-    return layered_network;
+    return network;
 }
 
+template <class Stats>
 class MaxFlowDinicFinder {
 public:
-    explicit MaxFlowDinicFinder(Graph& residual_network)
-        : residual_network_(residual_network) {
+    explicit MaxFlowDinicFinder(FlowNetwork* network)
+        : network_(*network),
+          levels_(network->VertexCount()),
+          current_arcs_(network->VertexCount()) {
+        network_.PrepareAdjacency();
     }
 
-    Capacity Find(size_t source, size_t target) {
+    // stops as soon as the flow reaches @limit
+    Capacity Find(size_t source, size_t target, Capacity limit = kNoLimit) {
+        if (source == target) {
+            return 0;
+        }
         Capacity flow = 0;
-        Capacity addend_flow;
-        while ((addend_flow = FindMaxBlockingFlow(source, target)) != 0) {
-            flow += addend_flow;
+        while (flow < limit) {
+            stats_.SwitchStage(MaxFlowStage::kBfs);
+            if (!MakeLevels(source, target)) {
+                break;
+            }
+            stats_.AddPhase();
+            for (size_t vertex = 0; vertex < current_arcs_.size(); ++vertex) {
+                current_arcs_[vertex] = network_.GetAdjacencyBegin(vertex);
+            }
+            stats_.SwitchStage(MaxFlowStage::kDfs);
+            flow += FindMaxBlockingFlow(source, target, limit - flow);
         }
+        stats_.SwitchStage(MaxFlowStage::kNone);
         return flow;
     }
 
-private:
-    using EdgeIterator = std::unordered_map<size_t, Capacity>::iterator;
+    // Delta-phases: only edges with residual capacity at least Delta are used, Delta goes from
+    // the largest capacity down to 1, which saves augmentations when capacities vary a lot
+    Capacity FindWithCapacityScaling(size_t source, size_t target) {
+        Capacity max_capacity = 0;
+        for (size_t edge = 0; edge < network_.EdgeCount(); ++edge) {
+            max_capacity = std::max(max_capacity, network_.GetCapacity(edge));
+        }
+        Capacity delta = 1;
+        while (delta <= max_capacity / 2) {
+            delta *= 2;
+        }
+        Capacity flow = 0;
+        for (; delta > 0; delta /= 2) {
+            min_capacity_ = delta;
+            flow += Find(source, target);
+        }
+        min_capacity_ = 1;
+        return flow;
+    }
 
-    Graph& residual_network_;
-    Graph layered_network_;
-    std::vector<EdgeIterator> unvisited_edges_;
+    size_t GetAugmentationCount() const {
+        return augmentation_count_;
+    }
 
-    Capacity FindMaxBlockingFlow(size_t source, size_t target) {
-        layered_network_ = MakeLayeredNetwork(residual_network_, source);
-        unvisited_edges_ = MakeUnvisitedEdges();
-        return FindFlow(source, target);
+    const Stats& GetStats() const {
+        return stats_;
     }
 
-    Capacity FindFlow(size_t current, size_t target, Capacity input_flow = INT32_MAX) {
-        if (current == target) {
-            return input_flow;
+private:
+    static constexpr int kUnreached = -1;
+    static constexpr Capacity kNoLimit = std::numeric_limits<Capacity>::max();
+
+    FlowNetwork& network_;
+    Stats stats_;
+    Capacity min_capacity_ = 1;
+    size_t augmentation_count_ = 0;
+    std::vector<int> levels_;
+    std::vector<size_t> current_arcs_;
+    std::vector<size_t> vertex_queue_;
+    std::vector<size_t> path_;
+
+    // BFS over edges with positive residual capacity, returns whether @target is reachable
+    bool MakeLevels(size_t source, size_t target) {
+        std::fill(levels_.begin(), levels_.end(), kUnreached);
+        levels_[source] = 0;
+        vertex_queue_.assign(1, source);
+        const std::vector<size_t>& adjacent_edges = network_.GetAdjacentEdges();
+        for (size_t index = 0; index < vertex_queue_.size(); ++index) {
+            size_t vertex = vertex_queue_[index];
+            for (size_t arc = network_.GetAdjacencyBegin(vertex);
+                 arc < network_.GetAdjacencyEnd(vertex); ++arc) {
+                size_t edge = adjacent_edges[arc];
+                size_t to = network_.GetTo(edge);
+                stats_.AddScannedEdge();
+                if (levels_[to] != kUnreached || network_.GetCapacity(edge) < min_capacity_) {
+                    continue;
+                }
+                levels_[to] = levels_[vertex] + 1;
+                vertex_queue_.push_back(to);
+            }
         }
-        Capacity flow = 0;
-        for (EdgeIterator& edge_iter = unvisited_edges_.at(current);
-             edge_iter != layered_network_.at(current).end();
-             ++edge_iter) {
+        return levels_[target] != kUnreached;
+    }
 
-            const auto& [next_vertex, capacity] = *edge_iter;
-            if (capacity == 0) {
+    // iterative DFS over the layered network: path_ holds the edges from source to the
+    // current vertex, dead ends are cut off by moving the current arc forward
+    Capacity FindMaxBlockingFlow(size_t source, size_t target, Capacity limit) {
+        const std::vector<size_t>& adjacent_edges = network_.GetAdjacentEdges();
+        Capacity flow = 0;
+        path_.clear();
+        size_t vertex = source;
+        while (true) {
+            if (vertex == target) {
+                flow += Augment(limit - flow);
+                if (flow == limit) {
+                    return flow;
+                }
+                vertex = path_.empty() ? source : network_.GetTo(path_.back());
                 continue;
             }
-            Capacity next_input_flow = std::min(capacity, input_flow);
-            Capacity addend_flow = FindFlow(next_vertex, target, next_input_flow);
-
-            flow += addend_flow;
-            input_flow -= addend_flow;
-
-            UpdateEdge(current, next_vertex, addend_flow, &layered_network_);
-            UpdateEdge(current, next_vertex, addend_flow, &residual_network_);
-
-            if (input_flow == 0) {
-                break;
+            size_t& arc = current_arcs_[vertex];
+            for (; arc < network_.GetAdjacencyEnd(vertex); ++arc) {
+                size_t edge = adjacent_edges[arc];
+                stats_.AddScannedEdge();
+                if (network_.GetCapacity(edge) >= min_capacity_ &&
+                    levels_[network_.GetTo(edge)] == levels_[vertex] + 1) {
+                    break;
+                }
             }
+            if (arc < network_.GetAdjacencyEnd(vertex)) {
+                path_.push_back(adjacent_edges[arc]);
+                vertex = network_.GetTo(path_.back());
+                continue;
+            }
+            if (path_.empty()) {
+                return flow;
+            }
+            vertex = network_.GetFrom(path_.back());
+            path_.pop_back();
+            ++current_arcs_[vertex];
         }
-        return flow;
     }
 
-    void UpdateEdge(size_t from, size_t to, Capacity addend_flow, Graph* graph) {
-        graph->at(from).at(to) -= addend_flow;
-
-        if (Contains(graph->at(to), from)) {
-            graph->at(to).at(from) += addend_flow;
+    // pushes the bottleneck along path_ and cuts the path before its first edge which became
+    // too thin
+    Capacity Augment(Capacity limit) {
+        stats_.SwitchStage(MaxFlowStage::kAugment);
+        stats_.AddAugmentingPath(path_.size());
+        Capacity bottleneck = limit;
+        for (size_t edge : path_) {
+            bottleneck = std::min(bottleneck, network_.GetCapacity(edge));
         }
-    }
-
-    std::vector<EdgeIterator> MakeUnvisitedEdges() {
-        std::vector<EdgeIterator> unvisited_edges;
-        for (auto& vertex_edges : layered_network_) {
-            unvisited_edges.push_back(vertex_edges.begin());
+        size_t first_saturated = path_.size();
+        for (size_t index = 0; index < path_.size(); ++index) {
+            network_.Push(path_[index], bottleneck);
+            if (network_.GetCapacity(path_[index]) < min_capacity_ &&
+                first_saturated == path_.size()) {
+                first_saturated = index;
+            }
         }
-        return unvisited_edges;
+        path_.resize(first_saturated);
+        ++augmentation_count_;
+        stats_.SwitchStage(MaxFlowStage::kDfs);
+        return bottleneck;
     }
 };
 
-Capacity FindMaxFlowDinic(size_t source, size_t target, const Graph& graph) {
-    Graph residual_network = MakeResidualNetwork(graph);
-    return FindMaxFlowDinicForResidualNetwork(source, target, &residual_network);
+Capacity FindMaxFlowDinic(FlowNetwork* network, size_t source, size_t target,
+                          bool capacity_scaling) {
+    MaxFlowDinicFinder finder(network);
+    return capacity_scaling ? finder.FindWithCapacityScaling(source, target)
+                            : finder.Find(source, target);
 }
 
+Capacity FindMaxFlowDinic(size_t source, size_t target, const Graph& graph,
+                          bool capacity_scaling) {
+    FlowNetwork network = MakeFlowNetwork(graph);
+    return FindMaxFlowDinic(&network, source, target, capacity_scaling);
+}
+
+Capacity FindMaxFlowDinic(size_t source, size_t target, const CsrGraph<Capacity>& graph,
+                          bool capacity_scaling) {
+    return FindMaxFlowDinic(source, target, graph.GetView(), capacity_scaling);
+}
+
+Capacity FindMaxFlowDinic(size_t source, size_t target, const CsrGraphView<Capacity>& graph,
+                          bool capacity_scaling) {
+    FlowNetwork network = MakeFlowNetwork(graph);
+    return FindMaxFlowDinic(&network, source, target, capacity_scaling);
+}
 
 Capacity FindMaxFlowDinicForResidualNetwork(size_t source, size_t target, Graph* residual_network) {
-    return MaxFlowDinicFinder(*residual_network).Find(source, target);
+    FlowNetwork network = MakeFlowNetwork(*residual_network);
+    Capacity flow = MaxFlowDinicFinder(&network).Find(source, target);
+    for (size_t edge = 0; edge < network.EdgeCount(); ++edge) {
+        (*residual_network)[network.GetFrom(edge)][network.GetTo(edge)] = network.GetCapacity(edge);
+    }
+    return flow;
+}
+
+// vertexes reachable from @source by edges with positive residual capacity
+std::vector<bool> FindReachableInResidualNetwork(const FlowNetwork& network, size_t source) {
+    std::vector<bool> reachable(network.VertexCount());
+    std::vector<size_t> vertex_stack = {source};
+    reachable[source] = true;
+    const std::vector<size_t>& adjacent_edges = network.GetAdjacentEdges();
+    while (!vertex_stack.empty()) {
+        size_t vertex = vertex_stack.back();
+        vertex_stack.pop_back();
+        for (size_t arc = network.GetAdjacencyBegin(vertex); arc < network.GetAdjacencyEnd(vertex);
+             ++arc) {
+            size_t edge = adjacent_edges[arc];
+            size_t to = network.GetTo(edge);
+            if (reachable[to] || network.GetCapacity(edge) == 0) {
+                continue;
+            }
+            reachable[to] = true;
+            vertex_stack.push_back(to);
+        }
+    }
+    return reachable;
 }
 
+// Answers any number of queries on one graph, the network is built once and only its flow
+// is reset between queries.
 class MinFlowEdgeCutFinder {
 public:
     explicit MinFlowEdgeCutFinder(const Graph& graph)
-        : graph_(graph),
-          residual_network_(MakeResidualNetwork(graph_)),
-          reachable_from_source_(graph.size()) {
+        : MinFlowEdgeCutFinder(graph, MakeFlowNetwork(graph)) {
+    }
+
+    // @network must be MakeFlowNetwork(@graph), possibly with some flow
+    MinFlowEdgeCutFinder(const Graph& graph, FlowNetwork network)
+        : graph_(graph), network_(std::move(network)), max_flow_finder_(&network_) {
     }
 
+    MinFlowEdgeCutFinder(const MinFlowEdgeCutFinder&) = delete;
+    MinFlowEdgeCutFinder& operator=(const MinFlowEdgeCutFinder&) = delete;
+
     std::vector<std::pair<size_t, size_t>> Find(size_t source, size_t target, Capacity* flow) {
-        Capacity max_flow = FindMaxFlowDinicForResidualNetwork(source, target, &residual_network_);
+        network_.ResetFlow();
+        Capacity max_flow = max_flow_finder_.Find(source, target);
         *flow = max_flow;
 
-        FindAllReachableFromVertex(source);
-        assert(!reachable_from_source_[target]);
+        std::vector<bool> reachable_from_source = FindReachableInResidualNetwork(network_, source);
+        assert(!reachable_from_source[target]);
 
         Capacity edge_cut_flow = 0;
         std::vector<std::pair<size_t, size_t>> cut_edges;
         for (size_t vertex = 0; vertex < graph_.size(); ++vertex) {
-            if (!reachable_from_source_[vertex]) {
+            if (!reachable_from_source[vertex]) {
                 continue;
             }
-            for (const auto& [to, capacity] : residual_network_[vertex]) {
-                if (reachable_from_source_[to]) {
+            for (const auto& [to, capacity] : graph_[vertex]) {
+                if (reachable_from_source[to]) {
                     continue;
                 }
-                assert(capacity == 0);
-                if (!Contains(graph_[vertex], to)) {
-                    continue;
-                }
-                Capacity addend_flow = residual_network_[to].at(vertex);
-                assert(addend_flow == graph_[vertex].at(to));
-                edge_cut_flow += addend_flow;
+                edge_cut_flow += capacity;
                 cut_edges.emplace_back(vertex, to);
             }
         }
@@ -222,26 +502,18 @@ public:
         return cut_edges;
     }
 
-private:
-    void FindAllReachableFromVertex(size_t vertex) {
-        assert(!reachable_from_source_[vertex]);
-        reachable_from_source_[vertex] = true;
-        for (const auto& [to, capacity] : residual_network_[vertex]) {
-            if (reachable_from_source_[to] || capacity == 0) {
-                continue;
-            }
-            FindAllReachableFromVertex(to);
-        }
-    }
-
 private:
     const Graph& graph_;
-    Graph residual_network_;
-    std::vector<bool> reachable_from_source_;
+    FlowNetwork network_;
+    MaxFlowDinicFinder<> max_flow_finder_;
 };
 
 std::vector<std::pair<size_t, size_t>> FindMinFlowEdgeCut(size_t source, size_t target,
                                                           const Graph& graph, Capacity* flow) {
 
     return MinFlowEdgeCutFinder(graph).Find(source, target, flow);
-}
\ No newline at end of file
+}
+
+}  // namespace dinic
+
+using namespace dinic;
@@ -1,3 +1,9 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+
 template <class T = int>
 class DisjointSetUnion {
 public:
@@ -20,7 +26,7 @@ public:
         if (first != second) {
             --sets_count_;
             if (rank_[first] < rank_[second]) {
-                swap(first, second);
+                std::swap(first, second);
             }
             parent_[second] = first;
             if (rank_[first] == rank_[second]) {
@@ -38,7 +44,7 @@ public:
     }
 
 private:
-    vector<T> parent_;
-    vector<int> rank_;
+    std::vector<T> parent_;
+    std::vector<int> rank_;
     size_t sets_count_;
 };
@@ -0,0 +1,296 @@
+#pragma once
+
+#include <vector>
+#include <unordered_set>
+#include <array>
+#include <cstdint>
+#include <cassert>
+
+#include "Kuhn.h"
+#include "HopcroftKarp.h"
+
+// INTERFACE
+
+namespace kuhn {
+
+// Maximum matching of a bipartite graph which follows edge insertions and deletions. The
+// matching stays maximum after every change, and a change only searches for the augmenting
+// paths it could create: an added edge can only be in the middle of a new augmenting path,
+// a deleted matched edge frees its two ends, and any new augmenting path starts at one of them.
+// Every part of such a path is looked for by two BFS over alternating paths at once, one from
+// the changed edge and one from all free vertexes of the other end; the first of them to finish
+// decides, so an update costs about the smaller of the two explored regions.
+// The vertex set and the left part are fixed, the first matching is found by Hopcroft-Karp.
+class DynamicMatching;
+
+// IMPLEMENTATION
+
+class DynamicMatching {
+public:
+    static constexpr size_t kNoVertex = SIZE_MAX;
+
+    DynamicMatching(const Graph& bipartite_graph, const std::vector<size_t>& left_part_vertexes)
+        : graph_(bipartite_graph),
+          reverse_graph_(graph_.size()),
+          left_part_vertexes_(left_part_vertexes),
+          is_left_(graph_.size(), false),
+          free_positions_(graph_.size(), kNoVertex) {
+        hopcroft_karp::HopcroftKarpMatchingFinder finder(graph_, left_part_vertexes_);
+        finder.Find();
+        matches_ = finder.GetMatches();
+        for (size_t left_vertex : left_part_vertexes_) {
+            is_left_[left_vertex] = true;
+            for (size_t right_vertex : graph_[left_vertex]) {
+                reverse_graph_[right_vertex].insert(left_vertex);
+            }
+        }
+        for (size_t vertex = 0; vertex < graph_.size(); ++vertex) {
+            if (matches_[vertex] == kNoVertex) {
+                AddFreeVertex(vertex);
+            } else if (is_left_[vertex]) {
+                ++matching_size_;
+            }
+        }
+        for (Search& search : searches_) {
+            search.visit_marks.assign(graph_.size(), 0);
+            search.parents.assign(graph_.size(), kNoVertex);
+        }
+    }
+
+    DynamicMatching(const Graph& bipartite_graph, size_t first_part_size)
+        : DynamicMatching(bipartite_graph, MakeFirstPartVertexes(first_part_size)) {
+    }
+
+    void AddEdge(size_t left_vertex, size_t right_vertex) {
+        assert(is_left_[left_vertex] && !is_left_[right_vertex]);
+        if (!graph_[left_vertex].insert(right_vertex).second) {
+            return;
+        }
+        reverse_graph_[right_vertex].insert(left_vertex);
+
+        // the matching was maximum, so the parts of a new augmenting path on both sides of
+        // the edge can not share a vertex: joined there they would make an older augmenting path
+        size_t left_part = kNoSearch;
+        if (matches_[left_vertex] != kNoVertex) {
+            StartSearch(0, false, matches_[left_vertex], left_vertex, kNoVertex);
+            StartSearch(1, true, kNoVertex, kNoVertex, matches_[left_vertex]);
+            left_part = Race(0, 1);
+            if (searches_[left_part].found == kNoVertex) {
+                return;
+            }
+        }
+        size_t right_part = kNoSearch;
+        if (matches_[right_vertex] != kNoVertex) {
+            // the search which found the left part keeps its parents
+            size_t first = left_part == 0 ? 1 : 0;
+            StartSearch(first, true, matches_[right_vertex], right_vertex, kNoVertex);
+            StartSearch(2, false, kNoVertex, kNoVertex, matches_[right_vertex]);
+            right_part = Race(first, 2);
+            if (searches_[right_part].found == kNoVertex) {
+                return;
+            }
+        }
+        if (left_part != kNoSearch) {
+            Flip(searches_[left_part]);
+        }
+        if (right_part != kNoSearch) {
+            Flip(searches_[right_part]);
+        }
+        Match(left_vertex, right_vertex);
+        ++matching_size_;
+    }
+
+    void RemoveEdge(size_t left_vertex, size_t right_vertex) {
+        assert(is_left_[left_vertex] && !is_left_[right_vertex]);
+        if (graph_[left_vertex].erase(right_vertex) == 0) {
+            return;
+        }
+        reverse_graph_[right_vertex].erase(left_vertex);
+        if (matches_[left_vertex] != right_vertex) {
+            return;
+        }
+        matches_[left_vertex] = kNoVertex;
+        matches_[right_vertex] = kNoVertex;
+        AddFreeVertex(left_vertex);
+        AddFreeVertex(right_vertex);
+        --matching_size_;
+
+        // one augmenting path at most, from the freed left vertex or to the freed right vertex
+        StartSearch(0, true, left_vertex, kNoVertex, kNoVertex);
+        StartSearch(1, false, kNoVertex, kNoVertex, left_vertex);
+        size_t winner = Race(0, 1);
+        if (searches_[winner].found == kNoVertex) {
+            StartSearch(0, false, right_vertex, kNoVertex, kNoVertex);
+            StartSearch(1, true, kNoVertex, kNoVertex, right_vertex);
+            winner = Race(0, 1);
+        }
+        if (searches_[winner].found != kNoVertex) {
+            Flip(searches_[winner]);
+            ++matching_size_;
+        }
+    }
+
+    size_t GetMatchingSize() const {
+        return matching_size_;
+    }
+
+    // partner of a left or a right vertex, kNoVertex if it is free
+    size_t GetMatch(size_t vertex) const {
+        return matches_[vertex];
+    }
+
+    // in the order of the left part
+    std::vector<Matching> GetMatching() const {
+        std::vector<Matching> result;
+        for (size_t left_vertex : left_part_vertexes_) {
+            if (matches_[left_vertex] != kNoVertex) {
+                result.emplace_back(left_vertex, matches_[left_vertex]);
+            }
+        }
+        return result;
+    }
+
+    const Graph& GetGraph() const {
+        return graph_;
+    }
+
+private:
+    static constexpr size_t kNoSearch = SIZE_MAX;
+
+    // BFS over alternating paths which is run one vertex at a time. A search from left vertexes
+    // goes by unmatched edges to right vertexes and by matched ones back, a search from right
+    // vertexes goes the same way backwards.
+    struct Search {
+        bool from_left = true;
+        // kNoVertex to start from all free vertexes of its side
+        size_t source = kNoVertex;
+        // the partner of source, never entered; the found path is flipped up to it
+        size_t stop = kNoVertex;
+        // the search ends at the first free vertex of the other side or at target
+        size_t target = kNoVertex;
+        size_t found = kNoVertex;
+        bool is_running = false;
+        // free sources go first, then vertex_queue
+        size_t source_index = 0;
+        size_t queue_index = 0;
+        std::vector<size_t> vertex_queue;
+        uint64_t stamp = 0;
+        std::vector<uint64_t> visit_marks;
+        // the vertex of the other side a vertex was reached from
+        std::vector<size_t> parents;
+    };
+
+    Graph graph_;
+    Graph reverse_graph_;
+    std::vector<size_t> left_part_vertexes_;
+    std::vector<bool> is_left_;
+    std::vector<size_t> matches_;
+    size_t matching_size_ = 0;
+
+    // indexed by is_left_, a vertex is removed by moving the last one to its place
+    std::array<std::vector<size_t>, 2> free_vertexes_;
+    std::vector<size_t> free_positions_;
+
+    std::array<Search, 3> searches_;
+
+    void AddFreeVertex(size_t vertex) {
+        std::vector<size_t>& free_vertexes = free_vertexes_[is_left_[vertex]];
+        free_positions_[vertex] = free_vertexes.size();
+        free_vertexes.push_back(vertex);
+    }
+
+    void RemoveFreeVertex(size_t vertex) {
+        std::vector<size_t>& free_vertexes = free_vertexes_[is_left_[vertex]];
+        size_t position = free_positions_[vertex];
+        free_vertexes[position] = free_vertexes.back();
+        free_positions_[free_vertexes[position]] = position;
+        free_vertexes.pop_back();
+        free_positions_[vertex] = kNoVertex;
+    }
+
+    void Match(size_t left_vertex, size_t right_vertex) {
+        for (size_t vertex : {left_vertex, right_vertex}) {
+            if (free_positions_[vertex] != kNoVertex) {
+                RemoveFreeVertex(vertex);
+            }
+        }
+        matches_[left_vertex] = right_vertex;
+        matches_[right_vertex] = left_vertex;
+    }
+
+    void StartSearch(size_t index, bool from_left, size_t source, size_t stop, size_t target) {
+        Search& search = searches_[index];
+        search.from_left = from_left;
+        search.source = source;
+        search.stop = stop;
+        search.target = target;
+        search.found = kNoVertex;
+        search.is_running = true;
+        search.source_index = 0;
+        search.queue_index = 0;
+        search.vertex_queue.clear();
+        ++search.stamp;
+        if (stop != kNoVertex) {
+            search.visit_marks[stop] = search.stamp;
+        }
+        if (source != kNoVertex) {
+            search.vertex_queue.push_back(source);
+        }
+    }
+
+    // takes the next vertex of the queue
+    void Step(Search* search) {
+        const std::vector<size_t>& free_sources = free_vertexes_[search->from_left];
+        size_t vertex;
+        if (search->source == kNoVertex && search->source_index < free_sources.size()) {
+            vertex = free_sources[search->source_index++];
+        } else if (search->queue_index < search->vertex_queue.size()) {
+            vertex = search->vertex_queue[search->queue_index++];
+        } else {
+            search->is_running = false;
+            return;
+        }
+        const Graph& graph = search->from_left ? graph_ : reverse_graph_;
+        for (size_t next : graph[vertex]) {
+            if (next == matches_[vertex] || search->visit_marks[next] == search->stamp) {
+                continue;
+            }
+            search->visit_marks[next] = search->stamp;
+            search->parents[next] = vertex;
+            if (matches_[next] == kNoVertex || next == search->target) {
+                search->found = next;
+                search->is_running = false;
+                return;
+            }
+            search->vertex_queue.push_back(matches_[next]);
+        }
+    }
+
+    // both searches answer the same question, the first one to finish gives the answer
+    size_t Race(size_t first, size_t second) {
+        while (true) {
+            for (size_t index : {first, second}) {
+                Step(&searches_[index]);
+                if (!searches_[index].is_running) {
+                    return index;
+                }
+            }
+        }
+    }
+
+    // every vertex of the found path takes the one it was reached from, up to search.stop
+    void Flip(const Search& search) {
+        for (size_t vertex = search.found; vertex != search.stop;) {
+            size_t parent = search.parents[vertex];
+            size_t next = matches_[parent];
+            if (search.from_left) {
+                Match(parent, vertex);
+            } else {
+                Match(vertex, parent);
+            }
+            vertex = next;
+        }
+    }
+};
+
+}  // namespace kuhn
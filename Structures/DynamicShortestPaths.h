@@ -0,0 +1,193 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cassert>
+
+#include "Dijkstra.h"
+#include "IndexedDaryHeap.h"
+
+// INTERFACE
+
+namespace dijkstra {
+
+// Shortest path tree from one source which follows edge updates. An improving update
+// (insertion or weight decrease) runs Dijkstra only from the improved endpoint; a worsening
+// update of a tree edge recomputes only the subtree hanging below it, in the spirit
+// of Ramalingam and Reps. Updates of non-tree edges which can not improve anything are O(1).
+class DynamicShortestPathTree;
+
+// IMPLEMENTATION
+
+class DynamicShortestPathTree {
+public:
+    DynamicShortestPathTree(Graph graph, Vertex source)
+        : graph_(std::move(graph)),
+          reversed_graph_(graph_.size()),
+          source_(source),
+          distances_(graph_.size(), kInfDistance),
+          parents_(graph_.size(), kNoVertex),
+          affected_marks_(graph_.size(), 0),
+          heap_(graph_.size()) {
+        for (Vertex from = 0; from < graph_.size(); ++from) {
+            for (const auto& [to, weight] : graph_[from]) {
+                assert(weight >= 0);
+                reversed_graph_[to][from] = weight;
+            }
+        }
+        distances_[source_] = 0;
+        heap_.Push(source_, 0);
+        Propagate();
+    }
+
+    // inserts the edge or changes its weight
+    void SetEdgeWeight(Vertex from, Vertex to, Distance weight) {
+        assert(weight >= 0);
+        auto iter = graph_[from].find(to);
+        if (iter == graph_[from].end() || weight < iter->second) {
+            graph_[from][to] = weight;
+            reversed_graph_[to][from] = weight;
+            OnEdgeImproved(from, to, weight);
+        } else if (weight > iter->second) {
+            iter->second = weight;
+            reversed_graph_[to][from] = weight;
+            OnEdgeWorsened(from, to);
+        }
+    }
+
+    void RemoveEdge(Vertex from, Vertex to) {
+        if (graph_[from].erase(to) == 0) {
+            return;
+        }
+        reversed_graph_[to].erase(from);
+        OnEdgeWorsened(from, to);
+    }
+
+    Distance GetDistance(Vertex vertex) const {
+        return distances_[vertex];
+    }
+
+    Vertex GetParent(Vertex vertex) const {
+        return parents_[vertex];
+    }
+
+    // the same as Dijkstra(GetGraph(), source) would return
+    const std::vector<Distance>& GetDistances() const {
+        return distances_;
+    }
+
+    const Graph& GetGraph() const {
+        return graph_;
+    }
+
+private:
+    Graph graph_;
+    Graph reversed_graph_;
+    Vertex source_;
+    std::vector<Distance> distances_;
+    std::vector<Vertex> parents_;
+
+    uint64_t affected_mark_ = 0;
+    std::vector<uint64_t> affected_marks_;
+    std::vector<Vertex> affected_;
+    DijkstraHeap heap_;
+
+    bool IsAffected(Vertex vertex) const {
+        return affected_marks_[vertex] == affected_mark_;
+    }
+
+    void OnEdgeImproved(Vertex from, Vertex to, Distance weight) {
+        if (distances_[from] == kInfDistance) {
+            return;
+        }
+        Distance new_distance = distances_[from] + weight;
+        if (distances_[to] != kInfDistance && distances_[to] <= new_distance) {
+            return;
+        }
+        distances_[to] = new_distance;
+        parents_[to] = from;
+        heap_.Push(to, new_distance);
+        Propagate();
+    }
+
+    // Dijkstra continued from the vertexes in heap_, distances_ of the rest are final
+    void Propagate() {
+        while (!heap_.Empty()) {
+            Vertex vertex = heap_.Top();
+            heap_.Pop();
+            for (const auto& [to, weight] : graph_[vertex]) {
+                Distance new_distance = distances_[vertex] + weight;
+                if (distances_[to] != kInfDistance && distances_[to] <= new_distance) {
+                    continue;
+                }
+                distances_[to] = new_distance;
+                parents_[to] = vertex;
+                heap_.PushOrDecreaseKey(to, new_distance);
+            }
+        }
+    }
+
+    void OnEdgeWorsened(Vertex from, Vertex to) {
+        if (parents_[to] != from) {
+            return;
+        }
+        CollectSubtree(to);
+
+        // the best way into every affected vertex from the unaffected part of the tree
+        for (Vertex vertex : affected_) {
+            distances_[vertex] = kInfDistance;
+            parents_[vertex] = kNoVertex;
+        }
+        for (Vertex vertex : affected_) {
+            for (const auto& [previous, weight] : reversed_graph_[vertex]) {
+                if (IsAffected(previous) || distances_[previous] == kInfDistance) {
+                    continue;
+                }
+                Distance new_distance = distances_[previous] + weight;
+                if (distances_[vertex] == kInfDistance || new_distance < distances_[vertex]) {
+                    distances_[vertex] = new_distance;
+                    parents_[vertex] = previous;
+                }
+            }
+            if (distances_[vertex] != kInfDistance) {
+                heap_.Push(vertex, distances_[vertex]);
+            }
+        }
+
+        // edges leaving the subtree can not improve unaffected vertexes, which are still final
+        while (!heap_.Empty()) {
+            Vertex vertex = heap_.Top();
+            heap_.Pop();
+            for (const auto& [next, weight] : graph_[vertex]) {
+                if (!IsAffected(next)) {
+                    continue;
+                }
+                Distance new_distance = distances_[vertex] + weight;
+                if (distances_[next] != kInfDistance && distances_[next] <= new_distance) {
+                    continue;
+                }
+                distances_[next] = new_distance;
+                parents_[next] = vertex;
+                heap_.PushOrDecreaseKey(next, new_distance);
+            }
+        }
+    }
+
+    void CollectSubtree(Vertex root) {
+        ++affected_mark_;
+        affected_.assign(1, root);
+        affected_marks_[root] = affected_mark_;
+        for (size_t index = 0; index < affected_.size(); ++index) {
+            Vertex vertex = affected_[index];
+            for (const auto& [child, weight] : graph_[vertex]) {
+                if (parents_[child] == vertex && !IsAffected(child)) {
+                    affected_marks_[child] = affected_mark_;
+                    affected_.push_back(child);
+                }
+            }
+        }
+    }
+};
+
+}  // namespace dijkstra
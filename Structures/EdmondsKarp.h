@@ -2,23 +2,49 @@
 
 #include <iostream>
 #include <vector>
-#include <queue>
 #include <unordered_map>
 #include <utility>
 #include <cassert>
 #include <algorithm>
 
+#include "CsrGraph.h"
+#include "Dinic.h"
+#include "MaxFlowStats.h"
+
 // ----------------------------------------------------------------------------
 // INTERFACE
 
+namespace edmonds_karp {
+
 using Capacity = int;
 
 using Graph = std::vector<std::unordered_map<size_t, Capacity>>;
 
 Graph MakeResidualNetwork(const Graph& graph);
 
+// flat residual network of Dinic, every edge gets its own pair, so parallel edges stay separate
+dinic::FlowNetwork MakeFlowNetwork(const CsrGraphView<Capacity>& graph);
+
+// Shortest augmenting paths over a residual network, see FindMaxFlowEdmondsKarp;
+// MaxFlowStats as @Stats collects counters and timings
+template <class Stats = NoMaxFlowStats>
+class MaxFlowEdmondsKarpFinder;
+
+// The same over a flat dinic::FlowNetwork, the flow is left in the network
+template <class Stats = NoMaxFlowStats>
+class FlowNetworkEdmondsKarpFinder;
+
 // NOTE: residual network is required, use MakeResidualNetwork for your graph if needed
-Capacity FindMaxFlowEdmondsKarp(size_t source, size_t target, Graph residual_network);
+// @capacity_scaling augments along wide paths first, worth it when capacities vary a lot
+Capacity FindMaxFlowEdmondsKarp(size_t source, size_t target, Graph residual_network,
+                                bool capacity_scaling = false);
+
+// run on the flat network of MakeFlowNetwork
+Capacity FindMaxFlowEdmondsKarp(size_t source, size_t target, const CsrGraph<Capacity>& graph,
+                                bool capacity_scaling = false);
+
+Capacity FindMaxFlowEdmondsKarp(size_t source, size_t target, const CsrGraphView<Capacity>& graph,
+                                bool capacity_scaling = false);
 
 // ----------------------------------------------------------------------------
 // IMPLEMENTATION
@@ -53,65 +79,267 @@ Graph MakeResidualNetwork(const Graph& graph) {
     return residual_network;
 }
 
-struct VertexInfo {
-    bool used;
-    size_t previous_vertex;
-};
+dinic::FlowNetwork MakeFlowNetwork(const CsrGraphView<Capacity>& graph) {
+    dinic::FlowNetwork network(graph.size());
+    for (size_t from = 0; from < graph.size(); ++from) {
+        for (const auto& [to, capacity] : graph[from]) {
+            if (from != to) {
+                network.AddEdge(from, to, capacity);
+            }
+        }
+    }
+    return network;
+}
+
+template <class Stats>
+class MaxFlowEdmondsKarpFinder {
+public:
+    explicit MaxFlowEdmondsKarpFinder(Graph* residual_network)
+        : residual_network_(*residual_network), vertex_infos_(residual_network->size()) {
+    }
 
-Capacity ApplyAddendFlow(size_t source, size_t target, const std::vector<VertexInfo>& vertex_infos,
-                         Graph* residual_network_ptr) {
+    Capacity Find(size_t source, size_t target) {
+        stats_.AddPhase();
+        stats_.SwitchStage(MaxFlowStage::kBfs);
+        Capacity flow = 0;
+        Capacity addend_flow;
+        while (FindAddendFlow(source, target, &addend_flow)) {
+            flow += addend_flow;
+        }
+        stats_.SwitchStage(MaxFlowStage::kNone);
+        return flow;
+    }
 
-    Graph& residual_network = *residual_network_ptr;
-    Capacity min_capacity = residual_network[vertex_infos[target].previous_vertex][target];
-    for (size_t vertex = target; vertex != source; vertex = vertex_infos[vertex].previous_vertex) {
-        size_t from = vertex_infos[vertex].previous_vertex;
-        size_t to = vertex;
-        min_capacity = std::min(min_capacity, residual_network[from][to]);
+    // Delta-phases: only edges with residual capacity at least Delta are used, Delta goes from
+    // the largest capacity down to 1, so a phase makes O(m) augmentations whatever the capacities
+    Capacity FindWithCapacityScaling(size_t source, size_t target) {
+        Capacity max_capacity = 0;
+        for (const auto& edges : residual_network_) {
+            for (const auto& [to, capacity] : edges) {
+                max_capacity = std::max(max_capacity, capacity);
+            }
+        }
+        Capacity flow = 0;
+        for (Capacity delta = GetHighestPowerOfTwo(max_capacity); delta > 0; delta /= 2) {
+            min_capacity_ = delta;
+            flow += Find(source, target);
+        }
+        min_capacity_ = 1;
+        return flow;
     }
-    assert(min_capacity > 0);
-    for (size_t vertex = target; vertex != source; vertex = vertex_infos[vertex].previous_vertex) {
-        size_t from = vertex_infos[vertex].previous_vertex;
-        size_t to = vertex;
-        residual_network[from][to] -= min_capacity;
-        residual_network[to][from] += min_capacity;
+
+    size_t GetAugmentationCount() const {
+        return augmentation_count_;
     }
-    return min_capacity;
-}
 
-bool FindAddendFlow(size_t source, size_t target, Graph* residual_network_ptr,
-                    Capacity* addend_flow) {
+    const Stats& GetStats() const {
+        return stats_;
+    }
+
+private:
+    struct VertexInfo {
+        size_t visit_mark = 0;
+        size_t previous_vertex = 0;
+    };
+
+    Graph& residual_network_;
+    Stats stats_;
+    Capacity min_capacity_ = 1;
+    size_t augmentation_count_ = 0;
 
-    Graph& residual_network = *residual_network_ptr;
-    std::queue<size_t> vertex_queue;
-    std::vector<VertexInfo> vertex_infos(residual_network.size());
+    // buffers of the BFS are reused, a vertex is visited iff its mark equals visit_mark_
+    size_t visit_mark_ = 0;
+    std::vector<VertexInfo> vertex_infos_;
+    std::vector<size_t> vertex_queue_;
+
+    static Capacity GetHighestPowerOfTwo(Capacity value) {
+        Capacity power = 1;
+        while (power <= value / 2) {
+            power *= 2;
+        }
+        return value == 0 ? 0 : power;
+    }
 
-    vertex_queue.push(source);
-    vertex_infos[source].used = true;
+    Capacity ApplyAddendFlow(size_t source, size_t target) {
+        stats_.SwitchStage(MaxFlowStage::kAugment);
+        Capacity min_capacity = residual_network_[vertex_infos_[target].previous_vertex][target];
+        size_t path_length = 0;
+        for (size_t vertex = target; vertex != source;
+             vertex = vertex_infos_[vertex].previous_vertex) {
+            size_t from = vertex_infos_[vertex].previous_vertex;
+            size_t to = vertex;
+            min_capacity = std::min(min_capacity, residual_network_[from][to]);
+            ++path_length;
+        }
+        stats_.AddAugmentingPath(path_length);
+        assert(min_capacity > 0);
+        for (size_t vertex = target; vertex != source;
+             vertex = vertex_infos_[vertex].previous_vertex) {
+            size_t from = vertex_infos_[vertex].previous_vertex;
+            size_t to = vertex;
+            residual_network_[from][to] -= min_capacity;
+            residual_network_[to][from] += min_capacity;
+        }
+        ++augmentation_count_;
+        stats_.SwitchStage(MaxFlowStage::kBfs);
+        return min_capacity;
+    }
 
-    while (!vertex_queue.empty()) {
-        size_t from = vertex_queue.front();
-        vertex_queue.pop();
+    bool FindAddendFlow(size_t source, size_t target, Capacity* addend_flow) {
+        ++visit_mark_;
+        vertex_queue_.assign(1, source);
+        vertex_infos_[source].visit_mark = visit_mark_;
 
-        for (const auto& [to, capacity] : residual_network[from]) {
-            if (vertex_infos[to].used || capacity == 0) {
-                continue;
+        for (size_t index = 0; index < vertex_queue_.size(); ++index) {
+            size_t from = vertex_queue_[index];
+            for (const auto& [to, capacity] : residual_network_[from]) {
+                stats_.AddScannedEdge();
+                if (vertex_infos_[to].visit_mark == visit_mark_ || capacity < min_capacity_) {
+                    continue;
+                }
+                vertex_infos_[to] = {visit_mark_, from};
+                if (to == target) {
+                    *addend_flow = ApplyAddendFlow(source, target);
+                    return true;
+                }
+                vertex_queue_.push_back(to);
             }
-            vertex_infos[to] = {true, from};
-            if (to == target) {
-                *addend_flow = ApplyAddendFlow(source, target, vertex_infos, residual_network_ptr);
-                return true;
+        }
+        return false;
+    }
+};
+
+template <class Stats>
+class FlowNetworkEdmondsKarpFinder {
+public:
+    explicit FlowNetworkEdmondsKarpFinder(dinic::FlowNetwork* network)
+        : network_(*network),
+          visit_marks_(network->VertexCount(), 0),
+          parent_edges_(network->VertexCount()) {
+        network_.PrepareAdjacency();
+    }
+
+    dinic::Capacity Find(size_t source, size_t target) {
+        if (source == target) {
+            return 0;
+        }
+        stats_.AddPhase();
+        stats_.SwitchStage(MaxFlowStage::kBfs);
+        dinic::Capacity flow = 0;
+        while (FindShortestPath(source, target)) {
+            flow += Augment(source, target);
+        }
+        stats_.SwitchStage(MaxFlowStage::kNone);
+        return flow;
+    }
+
+    // Delta-phases as in MaxFlowEdmondsKarpFinder::FindWithCapacityScaling
+    dinic::Capacity FindWithCapacityScaling(size_t source, size_t target) {
+        dinic::Capacity max_capacity = 0;
+        for (size_t edge = 0; edge < network_.EdgeCount(); ++edge) {
+            max_capacity = std::max(max_capacity, network_.GetCapacity(edge));
+        }
+        dinic::Capacity delta = 1;
+        while (delta <= max_capacity / 2) {
+            delta *= 2;
+        }
+        dinic::Capacity flow = 0;
+        for (; delta > 0; delta /= 2) {
+            min_capacity_ = delta;
+            flow += Find(source, target);
+        }
+        min_capacity_ = 1;
+        return flow;
+    }
+
+    size_t GetAugmentationCount() const {
+        return augmentation_count_;
+    }
+
+    const Stats& GetStats() const {
+        return stats_;
+    }
+
+private:
+    dinic::FlowNetwork& network_;
+    Stats stats_;
+    dinic::Capacity min_capacity_ = 1;
+    size_t augmentation_count_ = 0;
+
+    // a vertex is visited iff its mark equals visit_mark_, parent_edges_ lead back to the source
+    size_t visit_mark_ = 0;
+    std::vector<size_t> visit_marks_;
+    std::vector<size_t> parent_edges_;
+    std::vector<size_t> vertex_queue_;
+
+    bool FindShortestPath(size_t source, size_t target) {
+        ++visit_mark_;
+        visit_marks_[source] = visit_mark_;
+        vertex_queue_.assign(1, source);
+        const std::vector<size_t>& adjacent_edges = network_.GetAdjacentEdges();
+        for (size_t index = 0; index < vertex_queue_.size(); ++index) {
+            size_t vertex = vertex_queue_[index];
+            for (size_t arc = network_.GetAdjacencyBegin(vertex);
+                 arc < network_.GetAdjacencyEnd(vertex); ++arc) {
+                size_t edge = adjacent_edges[arc];
+                size_t to = network_.GetTo(edge);
+                stats_.AddScannedEdge();
+                if (visit_marks_[to] == visit_mark_ ||
+                    network_.GetCapacity(edge) < min_capacity_) {
+                    continue;
+                }
+                visit_marks_[to] = visit_mark_;
+                parent_edges_[to] = edge;
+                if (to == target) {
+                    return true;
+                }
+                vertex_queue_.push_back(to);
             }
-            vertex_queue.push(to);
         }
+        return false;
     }
-    return false;
-}
 
-Capacity FindMaxFlowEdmondsKarp(size_t source, size_t target, Graph residual_network) {
-    Capacity flow = 0;
-    Capacity addend_flow;
-    while (FindAddendFlow(source, target, &residual_network, &addend_flow)) {
-        flow += addend_flow;
+    dinic::Capacity Augment(size_t source, size_t target) {
+        stats_.SwitchStage(MaxFlowStage::kAugment);
+        dinic::Capacity bottleneck = network_.GetCapacity(parent_edges_[target]);
+        size_t path_length = 0;
+        for (size_t vertex = target; vertex != source;
+             vertex = network_.GetFrom(parent_edges_[vertex])) {
+            bottleneck = std::min(bottleneck, network_.GetCapacity(parent_edges_[vertex]));
+            ++path_length;
+        }
+        stats_.AddAugmentingPath(path_length);
+        assert(bottleneck > 0);
+        for (size_t vertex = target; vertex != source;
+             vertex = network_.GetFrom(parent_edges_[vertex])) {
+            network_.Push(parent_edges_[vertex], bottleneck);
+        }
+        ++augmentation_count_;
+        stats_.SwitchStage(MaxFlowStage::kBfs);
+        return bottleneck;
     }
-    return flow;
+};
+
+Capacity FindMaxFlowEdmondsKarp(size_t source, size_t target, Graph residual_network,
+                                bool capacity_scaling) {
+    MaxFlowEdmondsKarpFinder finder(&residual_network);
+    return capacity_scaling ? finder.FindWithCapacityScaling(source, target)
+                            : finder.Find(source, target);
+}
+
+Capacity FindMaxFlowEdmondsKarp(size_t source, size_t target, const CsrGraph<Capacity>& graph,
+                                bool capacity_scaling) {
+    return FindMaxFlowEdmondsKarp(source, target, graph.GetView(), capacity_scaling);
 }
+
+Capacity FindMaxFlowEdmondsKarp(size_t source, size_t target, const CsrGraphView<Capacity>& graph,
+                                bool capacity_scaling) {
+    dinic::FlowNetwork network = MakeFlowNetwork(graph);
+    FlowNetworkEdmondsKarpFinder finder(&network);
+    return capacity_scaling ? finder.FindWithCapacityScaling(source, target)
+                            : finder.Find(source, target);
+}
+
+}  // namespace edmonds_karp
+
+using namespace edmonds_karp;
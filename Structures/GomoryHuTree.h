@@ -0,0 +1,186 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cassert>
+
+#include "Dinic.h"
+#include "../Utils/thread_pool.h"
+
+// INTERFACE
+
+namespace dinic {
+
+// Flow-equivalent tree of an undirected network: the minimum cut between any two vertexes is
+// the lightest edge on the tree path between them. Answers in O(log n) by binary lifting.
+class GomoryHuTree;
+
+// Gusfield's algorithm, n - 1 Dinic runs. @graph must be symmetric: graph[u][v] == graph[v][u].
+// Runs whose tree parent can not change any more are done in parallel, in batches of
+// @thread_count consecutive vertexes; a run invalidated by an earlier cut of its batch is redone.
+GomoryHuTree BuildGomoryHuTree(const Graph& graph,
+                               size_t thread_count = std::thread::hardware_concurrency());
+
+// IMPLEMENTATION
+
+class GomoryHuTree {
+public:
+    // parents[0] is ignored, parents[v] < v for the rest; cuts[v] is the weight of v -> parents[v]
+    GomoryHuTree(std::vector<size_t> parents, std::vector<Capacity> cuts)
+        : parents_(std::move(parents)), cuts_(std::move(cuts)), depths_(parents_.size(), 0) {
+        size_t vertex_count = parents_.size();
+        while ((size_t{1} << level_count_) < std::max<size_t>(vertex_count, 2)) {
+            ++level_count_;
+        }
+        ancestors_.assign(level_count_ * vertex_count, 0);
+        min_cuts_.assign(level_count_ * vertex_count, kNoCut);
+        for (size_t vertex = 1; vertex < vertex_count; ++vertex) {
+            assert(parents_[vertex] < vertex);
+            depths_[vertex] = depths_[parents_[vertex]] + 1;
+            ancestors_[vertex] = parents_[vertex];
+            min_cuts_[vertex] = cuts_[vertex];
+        }
+        for (size_t level = 1; level < level_count_; ++level) {
+            for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+                size_t middle = GetAncestor(level - 1, vertex);
+                ancestors_[level * vertex_count + vertex] = GetAncestor(level - 1, middle);
+                min_cuts_[level * vertex_count + vertex] = std::min(
+                    GetLevelMinCut(level - 1, vertex), GetLevelMinCut(level - 1, middle));
+            }
+        }
+    }
+
+    size_t size() const {
+        return parents_.size();
+    }
+
+    size_t GetParent(size_t vertex) const {
+        return parents_[vertex];
+    }
+
+    // weight of the tree edge vertex -> GetParent(vertex), vertex != 0
+    Capacity GetParentCut(size_t vertex) const {
+        return cuts_[vertex];
+    }
+
+    Capacity GetMinCut(size_t first, size_t second) const {
+        assert(first != second);
+        if (depths_[first] < depths_[second]) {
+            std::swap(first, second);
+        }
+        Capacity min_cut = kNoCut;
+        size_t depth_difference = depths_[first] - depths_[second];
+        for (size_t level = 0; depth_difference != 0; ++level, depth_difference >>= 1) {
+            if (depth_difference & 1) {
+                min_cut = std::min(min_cut, GetLevelMinCut(level, first));
+                first = GetAncestor(level, first);
+            }
+        }
+        if (first == second) {
+            return min_cut;
+        }
+        for (size_t level = level_count_; level-- > 0;) {
+            if (GetAncestor(level, first) != GetAncestor(level, second)) {
+                min_cut = std::min(
+                    {min_cut, GetLevelMinCut(level, first), GetLevelMinCut(level, second)});
+                first = GetAncestor(level, first);
+                second = GetAncestor(level, second);
+            }
+        }
+        return std::min({min_cut, cuts_[first], cuts_[second]});
+    }
+
+private:
+    static constexpr Capacity kNoCut = std::numeric_limits<Capacity>::max();
+
+    std::vector<size_t> parents_;
+    std::vector<Capacity> cuts_;
+    std::vector<size_t> depths_;
+    size_t level_count_ = 1;
+    // [level * size() + vertex]: the 2^level-th ancestor and the lightest edge on the way to it
+    std::vector<size_t> ancestors_;
+    std::vector<Capacity> min_cuts_;
+
+    size_t GetAncestor(size_t level, size_t vertex) const {
+        return ancestors_[level * parents_.size() + vertex];
+    }
+
+    Capacity GetLevelMinCut(size_t level, size_t vertex) const {
+        return min_cuts_[level * parents_.size() + vertex];
+    }
+};
+
+class GomoryHuTreeBuilder {
+public:
+    GomoryHuTreeBuilder(const Graph& graph, size_t thread_count)
+        : vertex_count_(graph.size()),
+          thread_pool_(thread_count),
+          parents_(vertex_count_, 0),
+          cuts_(vertex_count_, 0),
+          runs_(thread_pool_.Size()) {
+        FlowNetwork network = MakeFlowNetwork(graph);
+        for (size_t edge = 0; edge < network.EdgeCount(); ++edge) {
+            assert(network.GetInitialCapacity(edge) == network.GetInitialCapacity(edge ^ 1));
+        }
+        network.PrepareAdjacency();
+        networks_.assign(thread_pool_.Size(), network);
+    }
+
+    GomoryHuTree Build() {
+        size_t next_vertex = 1;
+        while (next_vertex < vertex_count_) {
+            size_t batch_size = std::min(runs_.size(), vertex_count_ - next_vertex);
+            thread_pool_.ParallelFor(batch_size, [&](size_t index, size_t thread_index) {
+                Run(next_vertex + index, &runs_[index], &networks_[thread_index]);
+            });
+            for (size_t index = 0; index < batch_size; ++index) {
+                const CutRun& run = runs_[index];
+                if (run.parent != parents_[run.vertex]) {
+                    break;
+                }
+                Commit(run);
+                ++next_vertex;
+            }
+        }
+        return GomoryHuTree(std::move(parents_), std::move(cuts_));
+    }
+
+private:
+    struct CutRun {
+        size_t vertex = 0;
+        size_t parent = 0;
+        Capacity cut = 0;
+        std::vector<bool> source_side;
+    };
+
+    size_t vertex_count_;
+    ThreadPool thread_pool_;
+    std::vector<size_t> parents_;
+    std::vector<Capacity> cuts_;
+    std::vector<CutRun> runs_;
+    // a copy of the network per thread, flows are reset between runs
+    std::vector<FlowNetwork> networks_;
+
+    void Run(size_t vertex, CutRun* run, FlowNetwork* network) const {
+        run->vertex = vertex;
+        run->parent = parents_[vertex];
+        network->ResetFlow();
+        run->cut = MaxFlowDinicFinder(network).Find(vertex, run->parent);
+        run->source_side = FindReachableInResidualNetwork(*network, vertex);
+    }
+
+    void Commit(const CutRun& run) {
+        cuts_[run.vertex] = run.cut;
+        for (size_t other = run.vertex + 1; other < vertex_count_; ++other) {
+            if (run.source_side[other] && parents_[other] == run.parent) {
+                parents_[other] = run.vertex;
+            }
+        }
+    }
+};
+
+GomoryHuTree BuildGomoryHuTree(const Graph& graph, size_t thread_count) {
+    return GomoryHuTreeBuilder(graph, thread_count).Build();
+}
+
+}  // namespace dinic
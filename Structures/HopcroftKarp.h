@@ -0,0 +1,206 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+#include "CsrGraph.h"
+#include "Kuhn.h"
+
+// INTERFACE
+
+namespace hopcroft_karp {
+
+using kuhn::Graph;
+using kuhn::Matching;
+using kuhn::MakeFirstPartVertexes;
+
+// Hopcroft-Karp: every phase augments along a maximal set of vertex-disjoint shortest paths,
+// O(E sqrt(V)). Matches are kept in one dense array indexed by vertex, DFS is iterative.
+// Takes the same input as kuhn::FindMaxMatching and returns the matching in the order
+// of @left_part_vertexes.
+std::vector<Matching> FindMaxMatchingHopcroftKarp(const Graph& bipartite_graph,
+                                                  const std::vector<size_t>& left_part_vertexes);
+
+std::vector<Matching> FindMaxMatchingHopcroftKarp(const Graph& bipartite_graph,
+                                                  size_t first_part_size);
+
+std::vector<Matching> FindMaxMatchingHopcroftKarp(const CsrGraph<>& bipartite_graph,
+                                                  const std::vector<size_t>& left_part_vertexes);
+
+std::vector<Matching> FindMaxMatchingHopcroftKarp(const CsrGraph<>& bipartite_graph,
+                                                  size_t first_part_size);
+
+// IMPLEMENTATION
+
+template <class GraphType>
+class HopcroftKarpMatchingFinder {
+public:
+    static constexpr size_t kNoVertex = SIZE_MAX;
+
+    HopcroftKarpMatchingFinder(const GraphType& bipartite_graph,
+                               const std::vector<size_t>& left_part_vertexes)
+        : graph_(bipartite_graph),
+          left_part_vertexes_(left_part_vertexes),
+          matches_(graph_.size(), kNoVertex),
+          distances_(graph_.size(), kInfDistance) {
+        current_edges_.reserve(graph_.size());
+        for (size_t vertex = 0; vertex < graph_.size(); ++vertex) {
+            const auto& edges = graph_[vertex];
+            current_edges_.emplace_back(edges.begin(), edges.end());
+        }
+    }
+
+    std::vector<Matching> Find() {
+        MatchGreedily();
+        while (MakeDistances()) {
+            for (size_t left_vertex : left_part_vertexes_) {
+                if (matches_[left_vertex] == kNoVertex) {
+                    TryAugment(left_vertex);
+                }
+            }
+        }
+        std::vector<Matching> result;
+        for (size_t left_vertex : left_part_vertexes_) {
+            if (matches_[left_vertex] != kNoVertex) {
+                result.emplace_back(left_vertex, matches_[left_vertex]);
+            }
+        }
+        return result;
+    }
+
+    // partner of a left or a right vertex, kNoVertex if it is free
+    const std::vector<size_t>& GetMatches() const {
+        return matches_;
+    }
+
+private:
+    static constexpr size_t kInfDistance = SIZE_MAX;
+
+    using EdgeIterator = decltype(std::declval<const GraphType&>()[0].begin());
+
+    const GraphType& graph_;
+    const std::vector<size_t>& left_part_vertexes_;
+    std::vector<size_t> matches_;
+    // BFS layer of a left vertex, free left vertexes are the layer 0
+    std::vector<size_t> distances_;
+    // layer of the left end of the shortest augmenting paths
+    size_t free_distance_ = kInfDistance;
+    // [current, end) edges of a left vertex not yet tried in this phase
+    std::vector<std::pair<EdgeIterator, EdgeIterator>> current_edges_;
+    std::vector<size_t> vertex_queue_;
+    // left vertexes of the path being built, each points to its next right vertex by current edge
+    std::vector<size_t> stack_;
+
+    void MatchGreedily() {
+        for (size_t left_vertex : left_part_vertexes_) {
+            for (size_t right_vertex : graph_[left_vertex]) {
+                if (matches_[right_vertex] == kNoVertex) {
+                    matches_[right_vertex] = left_vertex;
+                    matches_[left_vertex] = right_vertex;
+                    break;
+                }
+            }
+        }
+    }
+
+    // BFS from all free left vertexes over alternating paths, returns whether some free right
+    // vertex is reachable
+    bool MakeDistances() {
+        vertex_queue_.clear();
+        for (size_t left_vertex : left_part_vertexes_) {
+            current_edges_[left_vertex].first = graph_[left_vertex].begin();
+            if (matches_[left_vertex] == kNoVertex) {
+                distances_[left_vertex] = 0;
+                vertex_queue_.push_back(left_vertex);
+            } else {
+                distances_[left_vertex] = kInfDistance;
+            }
+        }
+        free_distance_ = kInfDistance;
+        for (size_t index = 0; index < vertex_queue_.size(); ++index) {
+            size_t left_vertex = vertex_queue_[index];
+            if (distances_[left_vertex] >= free_distance_) {
+                break;
+            }
+            for (size_t right_vertex : graph_[left_vertex]) {
+                size_t next_left_vertex = matches_[right_vertex];
+                if (next_left_vertex == kNoVertex) {
+                    free_distance_ = std::min(free_distance_, distances_[left_vertex]);
+                } else if (distances_[next_left_vertex] == kInfDistance) {
+                    distances_[next_left_vertex] = distances_[left_vertex] + 1;
+                    vertex_queue_.push_back(next_left_vertex);
+                }
+            }
+        }
+        return free_distance_ != kInfDistance;
+    }
+
+    // iterative DFS along the BFS layers; as in Dinic every left vertex keeps its current edge
+    // for the whole phase, and a vertex without a way to a free right vertex leaves the layers
+    bool TryAugment(size_t root) {
+        stack_.clear();
+        stack_.push_back(root);
+        while (!stack_.empty()) {
+            size_t left_vertex = stack_.back();
+            auto& [edge, edges_end] = current_edges_[left_vertex];
+            if (edge == edges_end) {
+                distances_[left_vertex] = kInfDistance;
+                stack_.pop_back();
+                if (!stack_.empty()) {
+                    ++current_edges_[stack_.back()].first;
+                }
+                continue;
+            }
+            size_t next_left_vertex = matches_[*edge];
+            if (distances_[left_vertex] == free_distance_) {
+                if (next_left_vertex == kNoVertex) {
+                    ApplyPath();
+                    return true;
+                }
+            } else if (next_left_vertex != kNoVertex
+                       && distances_[next_left_vertex] == distances_[left_vertex] + 1) {
+                stack_.push_back(next_left_vertex);
+                continue;
+            }
+            ++edge;
+        }
+        return false;
+    }
+
+    // the used edges become matching edges, so they are not tried again in this phase
+    void ApplyPath() {
+        for (size_t left_vertex : stack_) {
+            auto& edge = current_edges_[left_vertex].first;
+            size_t right_vertex = *edge;
+            matches_[right_vertex] = left_vertex;
+            matches_[left_vertex] = right_vertex;
+            ++edge;
+        }
+    }
+};
+
+std::vector<Matching> FindMaxMatchingHopcroftKarp(const Graph& bipartite_graph,
+                                                  const std::vector<size_t>& left_part_vertexes) {
+    return HopcroftKarpMatchingFinder(bipartite_graph, left_part_vertexes).Find();
+}
+
+std::vector<Matching> FindMaxMatchingHopcroftKarp(const Graph& bipartite_graph,
+                                                  size_t first_part_size) {
+    return FindMaxMatchingHopcroftKarp(bipartite_graph, MakeFirstPartVertexes(first_part_size));
+}
+
+std::vector<Matching> FindMaxMatchingHopcroftKarp(const CsrGraph<>& bipartite_graph,
+                                                  const std::vector<size_t>& left_part_vertexes) {
+    return HopcroftKarpMatchingFinder(bipartite_graph, left_part_vertexes).Find();
+}
+
+std::vector<Matching> FindMaxMatchingHopcroftKarp(const CsrGraph<>& bipartite_graph,
+                                                  size_t first_part_size) {
+    return FindMaxMatchingHopcroftKarp(bipartite_graph, MakeFirstPartVertexes(first_part_size));
+}
+
+}  // namespace hopcroft_karp
+
+using namespace hopcroft_karp;
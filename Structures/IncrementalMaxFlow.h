@@ -0,0 +1,138 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <cassert>
+
+#include "Dinic.h"
+
+// INTERFACE
+
+namespace dinic {
+
+// Maximum flow between fixed vertexes which follows capacity changes without solving from
+// scratch. The residual network is kept between changes: an increase or a new edge only
+// allows more augmenting paths, which are searched lazily by the next GetMaxFlow; a decrease
+// below the current flow of the edge is repaired at once by rerouting the surplus around
+// the edge, and what can not be rerouted is returned to source and taken back from target.
+class IncrementalMaxFlow;
+
+// IMPLEMENTATION
+
+class IncrementalMaxFlow {
+public:
+    IncrementalMaxFlow(const Graph& graph, size_t source, size_t target)
+        : network_(MakeFlowNetwork(graph)),
+          finder_(&network_),
+          edge_ids_(graph.size()),
+          source_(source),
+          target_(target) {
+        assert(source_ != target_);
+        for (size_t edge = 0; edge < network_.EdgeCount(); ++edge) {
+            size_t from = network_.GetFrom(edge);
+            size_t to = network_.GetTo(edge);
+            if (Contains(graph[from], to)) {
+                edge_ids_[from][to] = edge;
+            }
+        }
+    }
+
+    // finder_ keeps a pointer to network_
+    IncrementalMaxFlow(const IncrementalMaxFlow&) = delete;
+    IncrementalMaxFlow& operator=(const IncrementalMaxFlow&) = delete;
+
+    // adds the edge from -> to or changes its capacity, self-loops are ignored
+    void SetCapacity(size_t from, size_t to, Capacity capacity) {
+        assert(capacity >= 0);
+        if (from == to) {
+            return;
+        }
+        auto iter = edge_ids_[from].find(to);
+        if (iter == edge_ids_[from].end()) {
+            edge_ids_[from][to] = network_.AddEdge(from, to, capacity);
+            has_pending_increase_ = true;
+            return;
+        }
+        size_t edge = iter->second;
+        Capacity old_capacity = network_.GetInitialCapacity(edge);
+        network_.SetInitialCapacity(edge, capacity);
+        if (capacity > old_capacity) {
+            has_pending_increase_ = true;
+        } else if (network_.GetCapacity(edge) < 0) {
+            RepairOverflow(edge);
+        }
+    }
+
+    // zero for absent edges
+    Capacity GetCapacity(size_t from, size_t to) const {
+        auto iter = edge_ids_[from].find(to);
+        return iter == edge_ids_[from].end() ? 0 : network_.GetInitialCapacity(iter->second);
+    }
+
+    // flow through from -> to in the current maximum flow
+    Capacity GetFlow(size_t from, size_t to) {
+        Augment();
+        auto iter = edge_ids_[from].find(to);
+        return iter == edge_ids_[from].end() ? 0 : std::max<Capacity>(
+                                                        network_.GetFlow(iter->second), 0);
+    }
+
+    Capacity GetMaxFlow() {
+        Augment();
+        return flow_;
+    }
+
+    const FlowNetwork& GetNetwork() {
+        Augment();
+        return network_;
+    }
+
+private:
+    FlowNetwork network_;
+    MaxFlowDinicFinder<> finder_;
+    std::vector<std::unordered_map<size_t, size_t>> edge_ids_;
+    size_t source_;
+    size_t target_;
+    Capacity flow_ = 0;
+    // the first GetMaxFlow solves from scratch
+    bool has_pending_increase_ = true;
+
+    void Augment() {
+        if (!has_pending_increase_) {
+            return;
+        }
+        network_.PrepareAdjacency();
+        flow_ += finder_.Find(source_, target_);
+        has_pending_increase_ = false;
+    }
+
+    // @edge carries more flow than its new capacity
+    void RepairOverflow(size_t edge) {
+        network_.PrepareAdjacency();
+        Capacity surplus = -network_.GetCapacity(edge);
+        network_.Push(edge, -surplus);
+        size_t from = network_.GetFrom(edge);
+        size_t to = network_.GetTo(edge);
+
+        // now @from has excess and @to lacks the same amount of flow
+        Capacity rerouted = finder_.Find(from, to, surplus);
+        Capacity rest = surplus - rerouted;
+        if (rest == 0) {
+            return;
+        }
+        // no path from -> to is left, so the excess came from source and the lack goes to target
+        if (from != source_) {
+            [[maybe_unused]] Capacity returned = finder_.Find(from, source_, rest);
+            assert(returned == rest);
+        }
+        if (to != target_) {
+            [[maybe_unused]] Capacity taken_back = finder_.Find(target_, to, rest);
+            assert(taken_back == rest);
+        }
+        flow_ -= rest;
+        // the cancelled flow may have another way now
+        has_pending_increase_ = true;
+    }
+};
+
+}  // namespace dinic
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <functional>
+#include <cstdint>
+#include <algorithm>
+#include <cassert>
+
+// INTERFACE
+
+// Min-heap (with respect to @Compare) of indexes in [0, capacity) with keys and @Arity children
+// per node. Positions of indexes live in a dense array, so Contains, GetKey and DecreaseKey
+// need no hashing; a wider node makes the heap shallower, which pays off on decrease-key heavy
+// workloads like Dijkstra.
+template <class Key, size_t Arity = 4, class Compare = std::less<Key>>
+class IndexedDaryHeap;
+
+// IMPLEMENTATION
+
+template <class Key, size_t Arity, class Compare>
+class IndexedDaryHeap {
+public:
+    static_assert(Arity >= 2);
+
+    explicit IndexedDaryHeap(size_t capacity = 0, Compare compare = Compare())
+        : positions_(capacity, kNotInHeap), compare_(compare) {
+    }
+
+    // grows the range of allowed indexes, keeps the content
+    void Reserve(size_t capacity) {
+        if (capacity > positions_.size()) {
+            positions_.resize(capacity, kNotInHeap);
+        }
+    }
+
+    void Push(size_t index, Key key) {
+        assert(index < positions_.size() && !Contains(index));
+        nodes_.push_back({std::move(key), index});
+        positions_[index] = nodes_.size() - 1;
+        ShiftUp(nodes_.size() - 1);
+    }
+
+    size_t Top() const {
+        return nodes_.front().index;
+    }
+
+    const Key& TopKey() const {
+        return nodes_.front().key;
+    }
+
+    void Pop() {
+        positions_[nodes_.front().index] = kNotInHeap;
+        if (nodes_.size() > 1) {
+            nodes_.front() = std::move(nodes_.back());
+            positions_[nodes_.front().index] = 0;
+        }
+        nodes_.pop_back();
+        if (!nodes_.empty()) {
+            ShiftDown(0);
+        }
+    }
+
+    void DecreaseKey(size_t index, Key key) {
+        size_t position = positions_[index];
+        assert(position != kNotInHeap && !compare_(nodes_[position].key, key));
+        nodes_[position].key = std::move(key);
+        ShiftUp(position);
+    }
+
+    // pushes @index or decreases its key, returns false if the current key is not greater
+    bool PushOrDecreaseKey(size_t index, Key key) {
+        if (!Contains(index)) {
+            Push(index, std::move(key));
+            return true;
+        }
+        if (!compare_(key, GetKey(index))) {
+            return false;
+        }
+        DecreaseKey(index, std::move(key));
+        return true;
+    }
+
+    bool Contains(size_t index) const {
+        return positions_[index] != kNotInHeap;
+    }
+
+    const Key& GetKey(size_t index) const {
+        return nodes_[positions_[index]].key;
+    }
+
+    bool Empty() const {
+        return nodes_.empty();
+    }
+
+    size_t Size() const {
+        return nodes_.size();
+    }
+
+    // O(Size()), not O(capacity)
+    void Clear() {
+        for (const Node& node : nodes_) {
+            positions_[node.index] = kNotInHeap;
+        }
+        nodes_.clear();
+    }
+
+private:
+    static constexpr size_t kNotInHeap = SIZE_MAX;
+
+    struct Node {
+        Key key;
+        size_t index;
+    };
+
+    std::vector<Node> nodes_;
+    std::vector<size_t> positions_;
+    Compare compare_;
+
+    // moves the hole instead of swapping, every node is written once
+    void ShiftUp(size_t position) {
+        Node node = std::move(nodes_[position]);
+        while (position != 0) {
+            size_t parent = (position - 1) / Arity;
+            if (!compare_(node.key, nodes_[parent].key)) {
+                break;
+            }
+            Place(position, std::move(nodes_[parent]));
+            position = parent;
+        }
+        Place(position, std::move(node));
+    }
+
+    void ShiftDown(size_t position) {
+        Node node = std::move(nodes_[position]);
+        while (true) {
+            size_t first_child = Arity * position + 1;
+            if (first_child >= nodes_.size()) {
+                break;
+            }
+            size_t last_child = std::min(first_child + Arity, nodes_.size());
+            size_t best_child = first_child;
+            for (size_t child = first_child + 1; child < last_child; ++child) {
+                if (compare_(nodes_[child].key, nodes_[best_child].key)) {
+                    best_child = child;
+                }
+            }
+            if (!compare_(nodes_[best_child].key, node.key)) {
+                break;
+            }
+            Place(position, std::move(nodes_[best_child]));
+            position = best_child;
+        }
+        Place(position, std::move(node));
+    }
+
+    void Place(size_t position, Node node) {
+        positions_[node.index] = position;
+        nodes_[position] = std::move(node);
+    }
+};
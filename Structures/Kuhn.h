@@ -5,8 +5,12 @@
 #include <unordered_map>
 #include <numeric>
 
+#include "CsrGraph.h"
+
 // INTERFACE
 
+namespace kuhn {
+
 using Graph = std::vector<std::unordered_set<size_t>>;
 
 struct Matching {
@@ -26,6 +30,12 @@ std::vector<Matching> FindMaxMatching(const Graph& bipartite_graph,
 std::vector<Matching> FindMaxMatching(const Graph& bipartite_graph,
                                       size_t first_part_size);
 
+std::vector<Matching> FindMaxMatching(const CsrGraph<>& bipartite_graph,
+                                      const std::vector<size_t>& left_part_vertexes);
+
+std::vector<Matching> FindMaxMatching(const CsrGraph<>& bipartite_graph,
+                                      size_t first_part_size);
+
 // IMPLEMENTATION
 
 template <class Container, class Element>
@@ -33,9 +43,10 @@ bool Contains(const Container& container, const Element& element) {
     return container.find(element) != container.end();
 }
 
+template <class GraphType>
 class KuhnMaxMatchingFinder {
 public:
-    KuhnMaxMatchingFinder(const Graph& bipartite_graph,
+    KuhnMaxMatchingFinder(const GraphType& bipartite_graph,
                           const std::vector<size_t>& left_part_vertexes)
         : graph_(bipartite_graph), left_part_vertexes_(left_part_vertexes), used_(graph_.size()) {
     }
@@ -69,7 +80,7 @@ public:
     }
 
 private:
-    const Graph& graph_;
+    const GraphType& graph_;
     const std::vector<size_t>& left_part_vertexes_;
     std::unordered_map<size_t, size_t> right_to_left_matching_;
     std::unordered_set<size_t> used_;
@@ -80,9 +91,28 @@ std::vector<Matching> FindMaxMatching(const Graph& bipartite_graph,
     return KuhnMaxMatchingFinder(bipartite_graph, left_part_vertexes).Find();
 }
 
-std::vector<Matching> FindMaxMatching(const Graph& bipartite_graph,
-                                      size_t first_part_size) {
+std::vector<size_t> MakeFirstPartVertexes(size_t first_part_size) {
     std::vector<size_t> left_part_vertexes(first_part_size);
     std::iota(left_part_vertexes.begin(), left_part_vertexes.end(), 0);
-    return FindMaxMatching(bipartite_graph, left_part_vertexes);
+    return left_part_vertexes;
+}
+
+std::vector<Matching> FindMaxMatching(const Graph& bipartite_graph,
+                                      size_t first_part_size) {
+    return FindMaxMatching(bipartite_graph, MakeFirstPartVertexes(first_part_size));
+}
+
+std::vector<Matching> FindMaxMatching(const CsrGraph<>& bipartite_graph,
+                                      const std::vector<size_t>& left_part_vertexes) {
+    return KuhnMaxMatchingFinder(bipartite_graph, left_part_vertexes).Find();
 }
+
+std::vector<Matching> FindMaxMatching(const CsrGraph<>& bipartite_graph,
+                                      size_t first_part_size) {
+    return FindMaxMatching(bipartite_graph, MakeFirstPartVertexes(first_part_size));
+}
+
+}  // namespace kuhn
+
+using namespace kuhn;
+
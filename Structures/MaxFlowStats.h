@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <sstream>
+#include <cstddef>
+
+// INTERFACE
+
+enum class MaxFlowStage {
+    kNone,
+    // building BFS levels or searching a shortest augmenting path
+    kBfs,
+    // searching augmenting paths in the layered network
+    kDfs,
+    // pushing flow along a found path
+    kAugment,
+};
+
+// Counters and wall time per stage of a max flow finder: pass it as the Stats parameter of
+// MaxFlowDinicFinder or one of the Edmonds-Karp finders and read it by GetStats(). The default
+// NoMaxFlowStats has the same interface with empty bodies, so the calls compile away.
+struct MaxFlowStats;
+
+struct NoMaxFlowStats;
+
+// IMPLEMENTATION
+
+struct MaxFlowStats {
+    using Clock = std::chrono::steady_clock;
+
+    // level graphs for Dinic, Delta-phases for Edmonds-Karp
+    size_t phases = 0;
+    size_t augmenting_paths = 0;
+    // in edges, summed over all augmenting paths
+    size_t total_path_length = 0;
+    size_t edges_scanned = 0;
+    // indexed by MaxFlowStage, time of kNone is not counted
+    std::array<double, 4> stage_seconds = {};
+
+    void AddPhase() {
+        ++phases;
+    }
+
+    void AddAugmentingPath(size_t length) {
+        ++augmenting_paths;
+        total_path_length += length;
+    }
+
+    void AddScannedEdge() {
+        ++edges_scanned;
+    }
+
+    // closes the running stage and starts @stage, so stages never overlap
+    void SwitchStage(MaxFlowStage stage) {
+        Clock::time_point now = Clock::now();
+        if (current_stage_ != MaxFlowStage::kNone) {
+            stage_seconds[static_cast<size_t>(current_stage_)] +=
+                std::chrono::duration<double>(now - stage_start_).count();
+        }
+        current_stage_ = stage;
+        stage_start_ = now;
+    }
+
+    double GetSeconds(MaxFlowStage stage) const {
+        return stage_seconds[static_cast<size_t>(stage)];
+    }
+
+    std::string ToJson() const {
+        std::ostringstream out;
+        out << "{\"phases\": " << phases << ", \"augmenting_paths\": " << augmenting_paths
+            << ", \"total_path_length\": " << total_path_length
+            << ", \"edges_scanned\": " << edges_scanned << ", \"seconds\": {\"bfs\": "
+            << GetSeconds(MaxFlowStage::kBfs) << ", \"dfs\": " << GetSeconds(MaxFlowStage::kDfs)
+            << ", \"augment\": " << GetSeconds(MaxFlowStage::kAugment) << "}}";
+        return out.str();
+    }
+
+private:
+    MaxFlowStage current_stage_ = MaxFlowStage::kNone;
+    Clock::time_point stage_start_;
+};
+
+struct NoMaxFlowStats {
+    void AddPhase() {
+    }
+
+    void AddAugmentingPath(size_t) {
+    }
+
+    void AddScannedEdge() {
+    }
+
+    void SwitchStage(MaxFlowStage) {
+    }
+};
@@ -0,0 +1,398 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <cassert>
+
+#include "CsrGraph.h"
+#include "Dijkstra.h"
+#include "Dinic.h"
+
+// INTERFACE
+
+namespace min_cost_flow {
+
+using Capacity = dinic::Capacity;
+using Cost = dijkstra::Distance;
+
+struct CapacityCost {
+    Capacity capacity;
+    Cost cost;
+};
+
+// the same adjacency as dinic::Graph, edges carry a cost per unit of flow
+using Graph = std::vector<std::unordered_map<size_t, CapacityCost>>;
+
+using FlowGraph = std::vector<std::unordered_map<size_t, Capacity>>;
+
+struct MinCostFlow {
+    Capacity flow = 0;
+    Cost cost = 0;
+    // edge_flows[from][to] is the flow through from -> to, with an entry for every edge but self-loops
+    FlowGraph edge_flows;
+};
+
+enum class MinCostFlowMethod {
+    // Dijkstra over reduced costs, O(flow * m log n); costs may be negative but must not form
+    // negative cycles, throws std::runtime_error if they do
+    kSuccessiveShortestPaths,
+    // a maximum flow from Dinic turned into a cheapest one by epsilon-scaling push-relabel
+    // (Goldberg and Tarjan), does not depend on the flow value; negative cycles are cancelled.
+    // Costs are multiplied by n + 1, so every |cost| must be at most max(Cost) / 8 / (n + 1),
+    // and the potentials must stay above -max(Cost) / 4; throws std::runtime_error otherwise
+    kCostScaling,
+};
+
+// maximum flow from @source to @target of minimum cost; self-loops are ignored
+MinCostFlow FindMinCostMaxFlow(
+    size_t source, size_t target, const Graph& graph,
+    MinCostFlowMethod method = MinCostFlowMethod::kSuccessiveShortestPaths);
+
+// parallel edges stay separate, their flows are summed up in edge_flows
+MinCostFlow FindMinCostMaxFlow(
+    size_t source, size_t target, const CsrGraph<CapacityCost>& graph,
+    MinCostFlowMethod method = MinCostFlowMethod::kSuccessiveShortestPaths);
+
+MinCostFlow FindMinCostMaxFlow(
+    size_t source, size_t target, const CsrGraphView<CapacityCost>& graph,
+    MinCostFlowMethod method = MinCostFlowMethod::kSuccessiveShortestPaths);
+
+// IMPLEMENTATION
+
+// Works on a dinic::FlowNetwork, @costs are indexed by its edges, reverse edges cost the opposite.
+class MinCostFlowFinder {
+public:
+    MinCostFlowFinder(dinic::FlowNetwork* network, const std::vector<Cost>& costs)
+        : network_(*network),
+          costs_(costs),
+          potentials_(network->VertexCount(), 0),
+          distances_(network->VertexCount(), kInfDistance),
+          parent_edges_(network->VertexCount()),
+          heap_(network->VertexCount()) {
+        assert(costs_.size() == network_.EdgeCount());
+        network_.PrepareAdjacency();
+    }
+
+    Capacity FindSuccessiveShortestPaths(size_t source, size_t target) {
+        if (source == target) {
+            return 0;
+        }
+        InitPotentials(source);
+        Capacity flow = 0;
+        while (FindShortestPath(source, target)) {
+            flow += Augment(source, target);
+        }
+        return flow;
+    }
+
+    Capacity FindCostScaling(size_t source, size_t target) {
+        Cost multiplier = network_.VertexCount() + 1;
+        Cost cost_limit = kScaledCostLimit / multiplier;
+        for (Cost cost : costs_) {
+            if (cost > cost_limit || cost < -cost_limit) {
+                throw std::runtime_error("min cost flow costs are too large for cost scaling");
+            }
+        }
+        Capacity flow = dinic::MaxFlowDinicFinder(&network_).Find(source, target);
+        scaled_costs_.resize(costs_.size());
+        Cost epsilon = 0;
+        for (size_t edge = 0; edge < costs_.size(); ++edge) {
+            scaled_costs_[edge] = costs_[edge] * multiplier;
+            epsilon = std::max(epsilon, std::abs(scaled_costs_[edge]));
+        }
+        std::fill(potentials_.begin(), potentials_.end(), 0);
+        excesses_.assign(network_.VertexCount(), 0);
+        current_arcs_.resize(network_.VertexCount());
+        // with costs multiplied by n + 1 a 1-optimal flow is optimal
+        while (epsilon > 1) {
+            epsilon = std::max<Cost>(epsilon / kCostScalingFactor, 1);
+            Refine(epsilon);
+        }
+        return flow;
+    }
+
+    Cost GetCost() const {
+        Cost cost = 0;
+        for (size_t edge = 0; edge < network_.EdgeCount(); edge += 2) {
+            cost += network_.GetFlow(edge) * costs_[edge];
+        }
+        return cost;
+    }
+
+private:
+    static constexpr Cost kInfDistance = dijkstra::kInfDistance;
+    static constexpr Cost kCostScalingFactor = 8;
+    // scaled costs up to kScaledCostLimit and potentials down to -kPotentialLimit keep every
+    // reduced cost and relabel candidate within Cost
+    static constexpr Cost kScaledCostLimit = std::numeric_limits<Cost>::max() / 8;
+    static constexpr Cost kPotentialLimit = std::numeric_limits<Cost>::max() / 4;
+
+    dinic::FlowNetwork& network_;
+    const std::vector<Cost>& costs_;
+    std::vector<Cost> potentials_;
+
+    std::vector<Cost> distances_;
+    std::vector<size_t> parent_edges_;
+    std::vector<size_t> touched_;
+    std::vector<size_t> settled_;
+    dijkstra::DijkstraHeap heap_;
+
+    std::vector<Cost> scaled_costs_;
+    std::vector<Capacity> excesses_;
+    std::vector<size_t> current_arcs_;
+    std::vector<size_t> active_;
+
+    Cost GetReducedCost(size_t edge) const {
+        return costs_[edge] + potentials_[network_.GetFrom(edge)] -
+               potentials_[network_.GetTo(edge)];
+    }
+
+    // Bellman-Ford distances make reduced costs non-negative, needed only for negative costs
+    void InitPotentials(size_t source) {
+        std::fill(potentials_.begin(), potentials_.end(), 0);
+        bool has_negative_cost = false;
+        for (size_t edge = 0; edge < network_.EdgeCount(); ++edge) {
+            has_negative_cost |= network_.GetCapacity(edge) > 0 && costs_[edge] < 0;
+        }
+        if (!has_negative_cost) {
+            return;
+        }
+        // kInfDistance is -1, a valid distance here
+        constexpr Cost kUnreached = std::numeric_limits<Cost>::max();
+        std::vector<Cost> distances(network_.VertexCount(), kUnreached);
+        distances[source] = 0;
+        for (size_t iteration = 0; iteration < network_.VertexCount(); ++iteration) {
+            bool changed = false;
+            for (size_t edge = 0; edge < network_.EdgeCount(); ++edge) {
+                size_t from = network_.GetFrom(edge);
+                size_t to = network_.GetTo(edge);
+                if (network_.GetCapacity(edge) == 0 || distances[from] == kUnreached) {
+                    continue;
+                }
+                if (distances[from] + costs_[edge] < distances[to]) {
+                    distances[to] = distances[from] + costs_[edge];
+                    changed = true;
+                }
+            }
+            if (!changed) {
+                break;
+            }
+            if (iteration + 1 == network_.VertexCount()) {
+                throw std::runtime_error("min cost flow graph has a negative cycle");
+            }
+        }
+        for (size_t vertex = 0; vertex < potentials_.size(); ++vertex) {
+            potentials_[vertex] = distances[vertex] == kUnreached ? 0 : distances[vertex];
+        }
+    }
+
+    // Dijkstra over reduced costs stopped at @target; potentials of vertexes proved closer than
+    // @target are shifted so that reduced costs stay non-negative and the path becomes tight
+    bool FindShortestPath(size_t source, size_t target) {
+        for (size_t vertex : touched_) {
+            distances_[vertex] = kInfDistance;
+        }
+        touched_.assign(1, source);
+        settled_.clear();
+        heap_.Clear();
+        distances_[source] = 0;
+        heap_.Push(source, 0);
+
+        const std::vector<size_t>& adjacent_edges = network_.GetAdjacentEdges();
+        while (!heap_.Empty()) {
+            size_t vertex = heap_.Top();
+            heap_.Pop();
+            if (vertex == target) {
+                break;
+            }
+            settled_.push_back(vertex);
+            for (size_t arc = network_.GetAdjacencyBegin(vertex);
+                 arc < network_.GetAdjacencyEnd(vertex); ++arc) {
+                size_t edge = adjacent_edges[arc];
+                if (network_.GetCapacity(edge) == 0) {
+                    continue;
+                }
+                size_t to = network_.GetTo(edge);
+                Cost reduced_cost = GetReducedCost(edge);
+                assert(reduced_cost >= 0);
+                Cost new_distance = distances_[vertex] + reduced_cost;
+                if (distances_[to] != kInfDistance && distances_[to] <= new_distance) {
+                    continue;
+                }
+                if (distances_[to] == kInfDistance) {
+                    touched_.push_back(to);
+                }
+                distances_[to] = new_distance;
+                parent_edges_[to] = edge;
+                heap_.PushOrDecreaseKey(to, new_distance);
+            }
+        }
+        if (distances_[target] == kInfDistance) {
+            return false;
+        }
+        for (size_t vertex : settled_) {
+            potentials_[vertex] -= distances_[target] - distances_[vertex];
+        }
+        return true;
+    }
+
+    Capacity Augment(size_t source, size_t target) {
+        Capacity bottleneck = network_.GetCapacity(parent_edges_[target]);
+        for (size_t vertex = target; vertex != source;) {
+            size_t edge = parent_edges_[vertex];
+            bottleneck = std::min(bottleneck, network_.GetCapacity(edge));
+            vertex = network_.GetFrom(edge);
+        }
+        for (size_t vertex = target; vertex != source;) {
+            size_t edge = parent_edges_[vertex];
+            network_.Push(edge, bottleneck);
+            vertex = network_.GetFrom(edge);
+        }
+        return bottleneck;
+    }
+
+    Cost GetScaledReducedCost(size_t edge) const {
+        return scaled_costs_[edge] + potentials_[network_.GetFrom(edge)] -
+               potentials_[network_.GetTo(edge)];
+    }
+
+    // turns a 2 * @epsilon-optimal flow into an @epsilon-optimal one of the same value
+    void Refine(Cost epsilon) {
+        for (size_t edge = 0; edge < network_.EdgeCount(); ++edge) {
+            Capacity capacity = network_.GetCapacity(edge);
+            if (capacity > 0 && GetScaledReducedCost(edge) < 0) {
+                network_.Push(edge, capacity);
+                excesses_[network_.GetFrom(edge)] -= capacity;
+                excesses_[network_.GetTo(edge)] += capacity;
+            }
+        }
+        active_.clear();
+        for (size_t vertex = 0; vertex < excesses_.size(); ++vertex) {
+            current_arcs_[vertex] = network_.GetAdjacencyBegin(vertex);
+            if (excesses_[vertex] > 0) {
+                active_.push_back(vertex);
+            }
+        }
+        for (size_t index = 0; index < active_.size(); ++index) {
+            Discharge(active_[index], epsilon);
+        }
+    }
+
+    void Discharge(size_t vertex, Cost epsilon) {
+        const std::vector<size_t>& adjacent_edges = network_.GetAdjacentEdges();
+        while (excesses_[vertex] > 0) {
+            size_t& arc = current_arcs_[vertex];
+            for (; arc < network_.GetAdjacencyEnd(vertex); ++arc) {
+                size_t edge = adjacent_edges[arc];
+                Capacity capacity = network_.GetCapacity(edge);
+                if (capacity == 0 || GetScaledReducedCost(edge) >= 0) {
+                    continue;
+                }
+                size_t to = network_.GetTo(edge);
+                Capacity flow = std::min(excesses_[vertex], capacity);
+                network_.Push(edge, flow);
+                excesses_[vertex] -= flow;
+                if (excesses_[to] <= 0 && excesses_[to] + flow > 0) {
+                    active_.push_back(to);
+                }
+                excesses_[to] += flow;
+                if (excesses_[vertex] == 0) {
+                    return;
+                }
+            }
+            Relabel(vertex, epsilon);
+        }
+    }
+
+    // the cheapest residual edge leaving @vertex gets reduced cost -@epsilon
+    void Relabel(size_t vertex, Cost epsilon) {
+        const std::vector<size_t>& adjacent_edges = network_.GetAdjacentEdges();
+        bool found = false;
+        Cost new_potential = 0;
+        for (size_t arc = network_.GetAdjacencyBegin(vertex);
+             arc < network_.GetAdjacencyEnd(vertex); ++arc) {
+            size_t edge = adjacent_edges[arc];
+            if (network_.GetCapacity(edge) == 0) {
+                continue;
+            }
+            Cost candidate = potentials_[network_.GetTo(edge)] - scaled_costs_[edge] - epsilon;
+            if (!found || candidate > new_potential) {
+                new_potential = candidate;
+                found = true;
+            }
+        }
+        assert(found);
+        // potentials only decrease, by O(n * epsilon) in every Refine
+        if (new_potential < -kPotentialLimit) {
+            throw std::runtime_error("min cost flow potentials overflow");
+        }
+        potentials_[vertex] = new_potential;
+        current_arcs_[vertex] = network_.GetAdjacencyBegin(vertex);
+    }
+};
+
+template <class AddEdges>
+MinCostFlow FindMinCostMaxFlow(size_t source, size_t target, size_t vertex_count,
+                               MinCostFlowMethod method, const AddEdges& add_edges) {
+    dinic::FlowNetwork network(vertex_count);
+    std::vector<Cost> costs;
+    add_edges([&](size_t from, size_t to, const CapacityCost& edge) {
+        assert(edge.capacity >= 0);
+        if (from == to) {
+            return;
+        }
+        network.AddEdge(from, to, edge.capacity);
+        costs.push_back(edge.cost);
+        costs.push_back(-edge.cost);
+    });
+
+    MinCostFlowFinder finder(&network, costs);
+    MinCostFlow result;
+    if (method == MinCostFlowMethod::kSuccessiveShortestPaths) {
+        result.flow = finder.FindSuccessiveShortestPaths(source, target);
+    } else {
+        result.flow = finder.FindCostScaling(source, target);
+    }
+    result.cost = finder.GetCost();
+    result.edge_flows.resize(vertex_count);
+    for (size_t edge = 0; edge < network.EdgeCount(); edge += 2) {
+        result.edge_flows[network.GetFrom(edge)][network.GetTo(edge)] += network.GetFlow(edge);
+    }
+    return result;
+}
+
+MinCostFlow FindMinCostMaxFlow(size_t source, size_t target, const Graph& graph,
+                               MinCostFlowMethod method) {
+    return FindMinCostMaxFlow(source, target, graph.size(), method, [&](const auto& add_edge) {
+        for (size_t from = 0; from < graph.size(); ++from) {
+            for (const auto& [to, edge] : graph[from]) {
+                add_edge(from, to, edge);
+            }
+        }
+    });
+}
+
+MinCostFlow FindMinCostMaxFlow(size_t source, size_t target, const CsrGraph<CapacityCost>& graph,
+                               MinCostFlowMethod method) {
+    return FindMinCostMaxFlow(source, target, graph.GetView(), method);
+}
+
+MinCostFlow FindMinCostMaxFlow(size_t source, size_t target,
+                               const CsrGraphView<CapacityCost>& graph, MinCostFlowMethod method) {
+    return FindMinCostMaxFlow(source, target, graph.size(), method, [&](const auto& add_edge) {
+        for (size_t from = 0; from < graph.size(); ++from) {
+            for (const auto& [to, edge] : graph[from]) {
+                add_edge(from, to, edge);
+            }
+        }
+    });
+}
+
+}  // namespace min_cost_flow
+
+using namespace min_cost_flow;
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <random>
+#include <unordered_map>
+#include <algorithm>
+
+#include "ConnectedComponents.h"
+#include "../Utils/thread_pool.h"
+
+// INTERFACE
+
+namespace connected_components {
+
+// Afforest (Sutton, Ben-Nun, Barak): a forest of parent pointers where every link hooks the
+// greater root under the smaller one by compare-and-swap, so the roots end up being the smallest
+// vertexes of the components. The first kSampledNeighbours edges of every vertex are linked in
+// rounds, which usually joins the giant component already; its label is guessed by sampling,
+// and the rest of the edges is only scanned for the vertexes outside of it. Every edge must be
+// present in both directions, as in the serial finder. Gives the same ComponentLabels.
+// Experimental: correct on any thread count, but the scaling over the serial finder is not
+// measured yet, see "benchmark parallel_components".
+ComponentLabels FindComponentLabelsParallel(
+    const Graph& graph, size_t thread_count = std::thread::hardware_concurrency());
+
+ComponentLabels FindComponentLabelsParallel(
+    const CsrGraph<>& graph, size_t thread_count = std::thread::hardware_concurrency());
+
+ComponentLabels FindComponentLabelsParallel(
+    const CsrGraphView<>& graph, size_t thread_count = std::thread::hardware_concurrency());
+
+// IMPLEMENTATION
+
+template <class GraphType>
+class AfforestFinder {
+public:
+    AfforestFinder(const GraphType& graph, size_t thread_count)
+        : graph_(graph), vertex_count_(graph.size()), thread_pool_(thread_count),
+          parents_(vertex_count_) {
+    }
+
+    ComponentLabels Find() {
+        ForEachChunked(vertex_count_, [&](size_t vertex) {
+            parents_[vertex].store(vertex, std::memory_order_relaxed);
+        });
+        for (size_t round = 0; round < kSampledNeighbours; ++round) {
+            ForEachChunked(vertex_count_, [&](size_t vertex) {
+                auto neighbor = graph_[vertex].begin();
+                auto end = graph_[vertex].end();
+                for (size_t index = 0; index < round && neighbor != end; ++index) {
+                    ++neighbor;
+                }
+                if (neighbor != end) {
+                    Link(vertex, *neighbor);
+                }
+            });
+            Compress();
+        }
+
+        size_t giant_root = SampleFrequentRoot();
+        ForEachChunked(vertex_count_, [&](size_t vertex) {
+            if (GetParent(vertex) == giant_root) {
+                return;
+            }
+            size_t index = 0;
+            for (size_t neighbor : graph_[vertex]) {
+                if (index++ >= kSampledNeighbours) {
+                    Link(vertex, neighbor);
+                }
+            }
+        });
+        Compress();
+        return MakeLabels();
+    }
+
+private:
+    static constexpr size_t kChunkSize = 256;
+    static constexpr size_t kSampledNeighbours = 2;
+    static constexpr size_t kSampleCount = 1024;
+
+    const GraphType& graph_;
+    size_t vertex_count_;
+    ThreadPool thread_pool_;
+    std::vector<std::atomic<size_t>> parents_;
+
+    // @task(index) for every index in [0, count), in chunks; a single chunk runs on the
+    // calling thread
+    template <class Task>
+    void ForEachChunked(size_t count, const Task& task) {
+        if (count <= kChunkSize) {
+            for (size_t index = 0; index < count; ++index) {
+                task(index);
+            }
+            return;
+        }
+        std::atomic<size_t> next_chunk{0};
+        thread_pool_.Run([&](size_t) {
+            size_t begin;
+            while ((begin = next_chunk.fetch_add(kChunkSize)) < count) {
+                size_t end = std::min(begin + kChunkSize, count);
+                for (size_t index = begin; index < end; ++index) {
+                    task(index);
+                }
+            }
+        });
+    }
+
+    size_t GetParent(size_t vertex) const {
+        return parents_[vertex].load(std::memory_order_relaxed);
+    }
+
+    // joins the trees of @first and @second, the smaller root stays a root
+    void Link(size_t first, size_t second) {
+        size_t first_parent = GetParent(first);
+        size_t second_parent = GetParent(second);
+        while (first_parent != second_parent) {
+            size_t high = std::max(first_parent, second_parent);
+            size_t low = std::min(first_parent, second_parent);
+            size_t high_parent = GetParent(high);
+            if (high_parent == low) {
+                return;
+            }
+            if (high_parent == high && parents_[high].compare_exchange_strong(
+                                           high_parent, low, std::memory_order_relaxed)) {
+                return;
+            }
+            first_parent = GetParent(GetParent(high));
+            second_parent = GetParent(low);
+        }
+    }
+
+    // every vertex points to its root
+    void Compress() {
+        ForEachChunked(vertex_count_, [&](size_t vertex) {
+            size_t parent = GetParent(vertex);
+            while (GetParent(parent) != parent) {
+                parent = GetParent(parent);
+            }
+            parents_[vertex].store(parent, std::memory_order_relaxed);
+        });
+    }
+
+    size_t SampleFrequentRoot() const {
+        if (vertex_count_ == 0) {
+            return 0;
+        }
+        std::mt19937_64 generator(vertex_count_);
+        std::unordered_map<size_t, size_t> counts;
+        size_t frequent_root = GetParent(0);
+        for (size_t sample = 0; sample < kSampleCount; ++sample) {
+            size_t root = GetParent(generator() % vertex_count_);
+            if (++counts[root] > counts[frequent_root]) {
+                frequent_root = root;
+            }
+        }
+        return frequent_root;
+    }
+
+    // roots are the smallest vertexes of their components, so numbering the roots in order
+    // gives the labels of the serial finder
+    ComponentLabels MakeLabels() {
+        ComponentLabels result;
+        result.labels.resize(vertex_count_);
+        for (size_t vertex = 0; vertex < vertex_count_; ++vertex) {
+            if (GetParent(vertex) == vertex) {
+                result.labels[vertex] = result.sizes.size();
+                result.sizes.push_back(0);
+            }
+        }
+        ForEachChunked(vertex_count_, [&](size_t vertex) {
+            size_t root = GetParent(vertex);
+            if (root != vertex) {
+                result.labels[vertex] = result.labels[root];
+            }
+        });
+        for (size_t label : result.labels) {
+            ++result.sizes[label];
+        }
+        return result;
+    }
+};
+
+ComponentLabels FindComponentLabelsParallel(const Graph& graph, size_t thread_count) {
+    return AfforestFinder(graph, thread_count).Find();
+}
+
+ComponentLabels FindComponentLabelsParallel(const CsrGraph<>& graph, size_t thread_count) {
+    return AfforestFinder(graph, thread_count).Find();
+}
+
+ComponentLabels FindComponentLabelsParallel(const CsrGraphView<>& graph, size_t thread_count) {
+    return AfforestFinder(graph, thread_count).Find();
+}
+
+}  // namespace connected_components
@@ -0,0 +1,271 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+#include "HopcroftKarp.h"
+#include "../Utils/thread_pool.h"
+
+// INTERFACE
+
+namespace hopcroft_karp {
+
+// Parallel Hopcroft-Karp. Every phase builds the BFS layers level-synchronously, then runs
+// the DFS from all free left vertexes at once. A right vertex is claimed atomically by the first
+// search which reaches it along the layers and is not visited again in the phase, so the found
+// augmenting paths are vertex-disjoint and are applied without locks. Claims of failed searches
+// only block dead ends, so a phase finds a path whenever the layers reach a free right vertex.
+// Starts from a greedy matching built in parallel with the same claims.
+// Experimental: correct on any thread count, but the scaling over the serial Hopcroft-Karp is
+// not measured yet, see "benchmark parallel_matching".
+std::vector<Matching> FindMaxMatchingParallel(
+    const Graph& bipartite_graph, const std::vector<size_t>& left_part_vertexes,
+    size_t thread_count = std::thread::hardware_concurrency());
+
+std::vector<Matching> FindMaxMatchingParallel(
+    const Graph& bipartite_graph, size_t first_part_size,
+    size_t thread_count = std::thread::hardware_concurrency());
+
+std::vector<Matching> FindMaxMatchingParallel(
+    const CsrGraph<>& bipartite_graph, const std::vector<size_t>& left_part_vertexes,
+    size_t thread_count = std::thread::hardware_concurrency());
+
+std::vector<Matching> FindMaxMatchingParallel(
+    const CsrGraph<>& bipartite_graph, size_t first_part_size,
+    size_t thread_count = std::thread::hardware_concurrency());
+
+// IMPLEMENTATION
+
+template <class GraphType>
+class ParallelMatchingFinder {
+public:
+    static constexpr size_t kNoVertex = SIZE_MAX;
+
+    ParallelMatchingFinder(const GraphType& bipartite_graph,
+                           const std::vector<size_t>& left_part_vertexes, size_t thread_count)
+        : graph_(bipartite_graph),
+          left_part_vertexes_(left_part_vertexes),
+          thread_pool_(thread_count),
+          matches_(graph_.size(), kNoVertex),
+          layers_(graph_.size()),
+          layer_marks_(graph_.size()),
+          claim_marks_(graph_.size()),
+          thread_lists_(thread_pool_.Size()),
+          stacks_(thread_pool_.Size()) {
+        current_edges_.reserve(graph_.size());
+        for (size_t vertex = 0; vertex < graph_.size(); ++vertex) {
+            const auto& edges = graph_[vertex];
+            current_edges_.emplace_back(edges.begin(), edges.end());
+            layer_marks_[vertex].store(0, std::memory_order_relaxed);
+            claim_marks_[vertex].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    std::vector<Matching> Find() {
+        MatchGreedily();
+        while (MakeLayers()) {
+            ForEachChunked(free_vertexes_.size(), [&](size_t index, size_t thread_index) {
+                TryAugment(free_vertexes_[index], &stacks_[thread_index]);
+            });
+        }
+        std::vector<Matching> result;
+        for (size_t left_vertex : left_part_vertexes_) {
+            if (matches_[left_vertex] != kNoVertex) {
+                result.emplace_back(left_vertex, matches_[left_vertex]);
+            }
+        }
+        return result;
+    }
+
+private:
+    static constexpr size_t kChunkSize = 256;
+    static constexpr size_t kNoLayer = SIZE_MAX;
+
+    using EdgeIterator = decltype(std::declval<const GraphType&>()[0].begin());
+
+    const GraphType& graph_;
+    const std::vector<size_t>& left_part_vertexes_;
+    ThreadPool thread_pool_;
+    // during the DFS a vertex is touched only by the search which claimed its right vertex
+    std::vector<size_t> matches_;
+
+    // phase_ stamps the marks, so they need no reset between phases
+    uint32_t phase_ = 1;
+    // BFS layer of a right vertex, the layer of the left vertex it was reached from;
+    // valid when layer_marks_ holds the current phase
+    std::vector<size_t> layers_;
+    std::vector<std::atomic<uint32_t>> layer_marks_;
+    std::vector<std::atomic<uint32_t>> claim_marks_;
+    // layer of the free right vertexes the shortest augmenting paths end at
+    size_t free_layer_ = kNoLayer;
+
+    std::vector<std::pair<EdgeIterator, EdgeIterator>> current_edges_;
+    std::vector<size_t> free_vertexes_;
+    std::vector<size_t> frontier_;
+    std::vector<std::vector<size_t>> thread_lists_;
+    std::vector<std::vector<size_t>> stacks_;
+
+    // @task(index, thread_index) for every index in [0, count), in chunks; a single chunk
+    // runs on the calling thread, late phases have few free vertexes
+    template <class Task>
+    void ForEachChunked(size_t count, const Task& task) {
+        if (count <= kChunkSize) {
+            for (size_t index = 0; index < count; ++index) {
+                task(index, 0);
+            }
+            return;
+        }
+        std::atomic<size_t> next_chunk{0};
+        thread_pool_.Run([&](size_t thread_index) {
+            size_t begin;
+            while ((begin = next_chunk.fetch_add(kChunkSize)) < count) {
+                size_t end = std::min(begin + kChunkSize, count);
+                for (size_t index = begin; index < end; ++index) {
+                    task(index, thread_index);
+                }
+            }
+        });
+    }
+
+    void GatherThreadLists(std::vector<size_t>* vertexes) {
+        vertexes->clear();
+        for (std::vector<size_t>& list : thread_lists_) {
+            vertexes->insert(vertexes->end(), list.begin(), list.end());
+            list.clear();
+        }
+    }
+
+    // true for the only caller which marks @vertex in this phase
+    bool Mark(std::vector<std::atomic<uint32_t>>* marks, size_t vertex) const {
+        std::atomic<uint32_t>& mark = (*marks)[vertex];
+        return mark.load(std::memory_order_relaxed) != phase_ &&
+               mark.exchange(phase_, std::memory_order_relaxed) != phase_;
+    }
+
+    void MatchGreedily() {
+        ForEachChunked(left_part_vertexes_.size(), [&](size_t index, size_t) {
+            size_t left_vertex = left_part_vertexes_[index];
+            for (size_t right_vertex : graph_[left_vertex]) {
+                if (Mark(&claim_marks_, right_vertex)) {
+                    matches_[right_vertex] = left_vertex;
+                    matches_[left_vertex] = right_vertex;
+                    break;
+                }
+            }
+        });
+    }
+
+    // returns whether some free right vertex is reachable
+    bool MakeLayers() {
+        ++phase_;
+        ForEachChunked(left_part_vertexes_.size(), [&](size_t index, size_t thread_index) {
+            size_t left_vertex = left_part_vertexes_[index];
+            if (matches_[left_vertex] == kNoVertex) {
+                thread_lists_[thread_index].push_back(left_vertex);
+            }
+        });
+        GatherThreadLists(&free_vertexes_);
+        frontier_ = free_vertexes_;
+        free_layer_ = kNoLayer;
+        for (size_t layer = 0; !frontier_.empty() && free_layer_ == kNoLayer; ++layer) {
+            std::atomic<bool> has_free_vertex{false};
+            ForEachChunked(frontier_.size(), [&](size_t index, size_t thread_index) {
+                for (size_t right_vertex : graph_[frontier_[index]]) {
+                    if (!Mark(&layer_marks_, right_vertex)) {
+                        continue;
+                    }
+                    layers_[right_vertex] = layer;
+                    if (matches_[right_vertex] == kNoVertex) {
+                        has_free_vertex.store(true, std::memory_order_relaxed);
+                    } else {
+                        thread_lists_[thread_index].push_back(matches_[right_vertex]);
+                    }
+                }
+            });
+            GatherThreadLists(&frontier_);
+            if (has_free_vertex.load()) {
+                free_layer_ = layer;
+            }
+        }
+        return free_layer_ != kNoLayer;
+    }
+
+    // DFS from @root along the layers, the depth of a left vertex in @stack is its layer;
+    // the claimed right vertexes stay claimed when the search fails, so no other search of
+    // the phase walks the same dead end again
+    bool TryAugment(size_t root, std::vector<size_t>* stack) {
+        stack->clear();
+        PushVertex(root, stack);
+        while (!stack->empty()) {
+            size_t left_vertex = stack->back();
+            size_t layer = stack->size() - 1;
+            auto& [edge, edges_end] = current_edges_[left_vertex];
+            if (edge == edges_end) {
+                stack->pop_back();
+                if (!stack->empty()) {
+                    ++current_edges_[stack->back()].first;
+                }
+                continue;
+            }
+            size_t right_vertex = *edge;
+            if (layer_marks_[right_vertex].load(std::memory_order_relaxed) != phase_ ||
+                layers_[right_vertex] != layer || !Mark(&claim_marks_, right_vertex)) {
+                ++edge;
+                continue;
+            }
+            if (matches_[right_vertex] == kNoVertex) {
+                ApplyPath(*stack);
+                return true;
+            }
+            if (layer == free_layer_) {
+                ++edge;
+                continue;
+            }
+            PushVertex(matches_[right_vertex], stack);
+        }
+        return false;
+    }
+
+    void PushVertex(size_t left_vertex, std::vector<size_t>* stack) {
+        current_edges_[left_vertex].first = graph_[left_vertex].begin();
+        stack->push_back(left_vertex);
+    }
+
+    // every left vertex of @stack points to its new right vertex by current edge
+    void ApplyPath(const std::vector<size_t>& stack) {
+        for (size_t left_vertex : stack) {
+            size_t right_vertex = *current_edges_[left_vertex].first;
+            matches_[right_vertex] = left_vertex;
+            matches_[left_vertex] = right_vertex;
+        }
+    }
+};
+
+std::vector<Matching> FindMaxMatchingParallel(const Graph& bipartite_graph,
+                                              const std::vector<size_t>& left_part_vertexes,
+                                              size_t thread_count) {
+    return ParallelMatchingFinder(bipartite_graph, left_part_vertexes, thread_count).Find();
+}
+
+std::vector<Matching> FindMaxMatchingParallel(const Graph& bipartite_graph, size_t first_part_size,
+                                              size_t thread_count) {
+    return FindMaxMatchingParallel(bipartite_graph, MakeFirstPartVertexes(first_part_size),
+                                   thread_count);
+}
+
+std::vector<Matching> FindMaxMatchingParallel(const CsrGraph<>& bipartite_graph,
+                                              const std::vector<size_t>& left_part_vertexes,
+                                              size_t thread_count) {
+    return ParallelMatchingFinder(bipartite_graph, left_part_vertexes, thread_count).Find();
+}
+
+std::vector<Matching> FindMaxMatchingParallel(const CsrGraph<>& bipartite_graph,
+                                              size_t first_part_size, size_t thread_count) {
+    return FindMaxMatchingParallel(bipartite_graph, MakeFirstPartVertexes(first_part_size),
+                                   thread_count);
+}
+
+}  // namespace hopcroft_karp
@@ -0,0 +1,292 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <algorithm>
+
+#include "PushRelabel.h"
+#include "../Utils/thread_pool.h"
+
+// INTERFACE
+
+namespace push_relabel {
+
+// Synchronous parallel push-relabel: every round all active vertexes push along admissible edges
+// at once with heights frozen, then the ones left with excess are relabeled at once, received
+// excess is applied and the next active set is built. With heights frozen an edge pair is never
+// touched from both ends in one round, so residual capacities need no atomics; only the excess
+// received from neighbours is accumulated atomically. Global relabeling is a parallel BFS.
+// Like MaxFlowPushRelabelFinder, leaves a maximum preflow in the network.
+// Experimental: correct on any thread count, but the scaling over the serial finder is not
+// measured yet, see "benchmark parallel_push_relabel".
+class ParallelPushRelabelFinder;
+
+Capacity FindMaxFlowParallelPushRelabel(size_t source, size_t target, const Graph& graph,
+                                        size_t thread_count = std::thread::hardware_concurrency());
+
+Capacity FindMaxFlowParallelPushRelabel(size_t source, size_t target,
+                                        const CsrGraph<Capacity>& graph,
+                                        size_t thread_count = std::thread::hardware_concurrency());
+
+Capacity FindMaxFlowParallelPushRelabel(size_t source, size_t target,
+                                        const CsrGraphView<Capacity>& graph,
+                                        size_t thread_count = std::thread::hardware_concurrency());
+
+// IMPLEMENTATION
+
+class ParallelPushRelabelFinder {
+public:
+    ParallelPushRelabelFinder(FlowNetwork* network, size_t thread_count)
+        : network_(*network),
+          vertex_count_(network->VertexCount()),
+          thread_pool_(thread_count),
+          heights_(vertex_count_),
+          new_heights_(vertex_count_),
+          excesses_(vertex_count_),
+          incoming_(vertex_count_),
+          round_marks_(vertex_count_),
+          thread_lists_(thread_pool_.Size()) {
+        network_.PrepareAdjacency();
+        for (size_t vertex = 0; vertex < vertex_count_; ++vertex) {
+            incoming_[vertex].store(0, std::memory_order_relaxed);
+            round_marks_[vertex].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    Capacity Find(size_t source, size_t target) {
+        if (source == target) {
+            return 0;
+        }
+        source_ = source;
+        target_ = target;
+        std::fill(excesses_.begin(), excesses_.end(), 0);
+
+        const std::vector<size_t>& adjacent_edges = network_.GetAdjacentEdges();
+        for (size_t arc = network_.GetAdjacencyBegin(source_);
+             arc < network_.GetAdjacencyEnd(source_); ++arc) {
+            size_t edge = adjacent_edges[arc];
+            Capacity capacity = network_.GetCapacity(edge);
+            if (capacity > 0) {
+                network_.Push(edge, capacity);
+                excesses_[network_.GetTo(edge)] += capacity;
+                excesses_[source_] -= capacity;
+            }
+        }
+
+        GlobalRelabel();
+        while (!active_.empty()) {
+            PushPhase();
+            RelabelPhase();
+            ApplyPhase();
+            if (work_since_global_relabel_ > GetGlobalRelabelThreshold()) {
+                GlobalRelabel();
+            }
+        }
+        GlobalRelabel();
+        return excesses_[target_];
+    }
+
+    // whether @vertex can not reach target in the residual network after Find
+    bool IsOnSourceSide(size_t vertex) const {
+        return heights_[vertex] >= vertex_count_;
+    }
+
+private:
+    static constexpr size_t kChunkSize = 256;
+    static constexpr size_t kRelabelWork = 12;
+    static constexpr size_t kGlobalRelabelVertexFactor = 6;
+
+    FlowNetwork& network_;
+    size_t vertex_count_;
+    ThreadPool thread_pool_;
+    size_t source_ = 0;
+    size_t target_ = 0;
+
+    // heights_ are frozen during a round, relabeling writes new_heights_
+    std::vector<size_t> heights_;
+    std::vector<size_t> new_heights_;
+    // excess of a vertex is changed only by the thread processing it, the rest goes to incoming_
+    std::vector<Capacity> excesses_;
+    std::vector<std::atomic<Capacity>> incoming_;
+
+    // a vertex joins touched_ at most once per round, and the BFS frontier at most once per BFS
+    uint64_t round_mark_ = 0;
+    std::vector<std::atomic<uint64_t>> round_marks_;
+
+    std::vector<size_t> active_;
+    std::vector<size_t> touched_;
+    std::vector<std::vector<size_t>> thread_lists_;
+    std::atomic<size_t> work_since_global_relabel_{0};
+
+    size_t GetGlobalRelabelThreshold() const {
+        return kGlobalRelabelVertexFactor * vertex_count_ + network_.EdgeCount() / 2;
+    }
+
+    // @task(index, thread_index) for every index in [0, count), in chunks; a single chunk
+    // runs on the calling thread, rounds with few active vertexes are common near the end
+    template <class Task>
+    void ForEachChunked(size_t count, const Task& task) {
+        if (count <= kChunkSize) {
+            for (size_t index = 0; index < count; ++index) {
+                task(index, 0);
+            }
+            return;
+        }
+        std::atomic<size_t> next_chunk{0};
+        thread_pool_.Run([&](size_t thread_index) {
+            size_t begin;
+            while ((begin = next_chunk.fetch_add(kChunkSize)) < count) {
+                size_t end = std::min(begin + kChunkSize, count);
+                for (size_t index = begin; index < end; ++index) {
+                    task(index, thread_index);
+                }
+            }
+        });
+    }
+
+    void Touch(size_t vertex, size_t thread_index) {
+        uint64_t mark = round_marks_[vertex].load(std::memory_order_relaxed);
+        while (mark != round_mark_) {
+            if (round_marks_[vertex].compare_exchange_weak(mark, round_mark_,
+                                                           std::memory_order_relaxed)) {
+                thread_lists_[thread_index].push_back(vertex);
+                return;
+            }
+        }
+    }
+
+    void GatherThreadLists(std::vector<size_t>* vertexes) {
+        vertexes->clear();
+        for (std::vector<size_t>& list : thread_lists_) {
+            vertexes->insert(vertexes->end(), list.begin(), list.end());
+            list.clear();
+        }
+    }
+
+    void PushPhase() {
+        ++round_mark_;
+        const std::vector<size_t>& adjacent_edges = network_.GetAdjacentEdges();
+        ForEachChunked(active_.size(), [&](size_t index, size_t thread_index) {
+            size_t vertex = active_[index];
+            Capacity excess = excesses_[vertex];
+            for (size_t arc = network_.GetAdjacencyBegin(vertex);
+                 arc < network_.GetAdjacencyEnd(vertex) && excess > 0; ++arc) {
+                size_t edge = adjacent_edges[arc];
+                size_t to = network_.GetTo(edge);
+                // the height check goes first: the opposite end may be pushing into this edge
+                if (heights_[to] + 1 != heights_[vertex]) {
+                    continue;
+                }
+                Capacity capacity = network_.GetCapacity(edge);
+                if (capacity == 0) {
+                    continue;
+                }
+                Capacity flow = std::min(excess, capacity);
+                network_.Push(edge, flow);
+                excess -= flow;
+                incoming_[to].fetch_add(flow, std::memory_order_relaxed);
+                Touch(to, thread_index);
+            }
+            excesses_[vertex] = excess;
+        });
+    }
+
+    // vertexes left with excess had no admissible edges, so each of them gets a greater height
+    void RelabelPhase() {
+        const std::vector<size_t>& adjacent_edges = network_.GetAdjacentEdges();
+        ForEachChunked(active_.size(), [&](size_t index, size_t thread_index) {
+            size_t vertex = active_[index];
+            if (excesses_[vertex] == 0) {
+                return;
+            }
+            size_t new_height = vertex_count_;
+            for (size_t arc = network_.GetAdjacencyBegin(vertex);
+                 arc < network_.GetAdjacencyEnd(vertex); ++arc) {
+                size_t edge = adjacent_edges[arc];
+                if (network_.GetCapacity(edge) > 0) {
+                    new_height = std::min(new_height, heights_[network_.GetTo(edge)] + 1);
+                }
+            }
+            new_heights_[vertex] = new_height;
+            work_since_global_relabel_.fetch_add(
+                kRelabelWork + network_.GetAdjacencyEnd(vertex) - network_.GetAdjacencyBegin(vertex),
+                std::memory_order_relaxed);
+            Touch(vertex, thread_index);
+        });
+        GatherThreadLists(&touched_);
+    }
+
+    void ApplyPhase() {
+        ForEachChunked(touched_.size(), [&](size_t index, size_t thread_index) {
+            size_t vertex = touched_[index];
+            heights_[vertex] = new_heights_[vertex];
+            excesses_[vertex] += incoming_[vertex].exchange(0, std::memory_order_relaxed);
+            if (IsActive(vertex)) {
+                thread_lists_[thread_index].push_back(vertex);
+            }
+        });
+        GatherThreadLists(&active_);
+    }
+
+    bool IsActive(size_t vertex) const {
+        return vertex != source_ && vertex != target_ && excesses_[vertex] > 0 &&
+               heights_[vertex] < vertex_count_;
+    }
+
+    // exact heights by a level-synchronous backward BFS from target
+    void GlobalRelabel() {
+        work_since_global_relabel_.store(0, std::memory_order_relaxed);
+        ForEachChunked(vertex_count_, [&](size_t vertex, size_t) {
+            heights_[vertex] = vertex_count_;
+        });
+
+        ++round_mark_;
+        const std::vector<size_t>& adjacent_edges = network_.GetAdjacentEdges();
+        round_marks_[target_].store(round_mark_, std::memory_order_relaxed);
+        round_marks_[source_].store(round_mark_, std::memory_order_relaxed);
+        std::vector<size_t> frontier = {target_};
+        for (size_t height = 0; !frontier.empty(); ++height) {
+            ForEachChunked(frontier.size(), [&](size_t index, size_t thread_index) {
+                size_t vertex = frontier[index];
+                heights_[vertex] = height;
+                for (size_t arc = network_.GetAdjacencyBegin(vertex);
+                     arc < network_.GetAdjacencyEnd(vertex); ++arc) {
+                    size_t edge = adjacent_edges[arc];
+                    if (network_.GetCapacity(edge ^ 1) > 0) {
+                        Touch(network_.GetTo(edge), thread_index);
+                    }
+                }
+            });
+            GatherThreadLists(&frontier);
+        }
+
+        ForEachChunked(vertex_count_, [&](size_t vertex, size_t thread_index) {
+            new_heights_[vertex] = heights_[vertex];
+            if (IsActive(vertex)) {
+                thread_lists_[thread_index].push_back(vertex);
+            }
+        });
+        GatherThreadLists(&active_);
+    }
+};
+
+Capacity FindMaxFlowParallelPushRelabel(size_t source, size_t target, const Graph& graph,
+                                        size_t thread_count) {
+    FlowNetwork network = MakeFlowNetwork(graph);
+    return ParallelPushRelabelFinder(&network, thread_count).Find(source, target);
+}
+
+Capacity FindMaxFlowParallelPushRelabel(size_t source, size_t target,
+                                        const CsrGraph<Capacity>& graph, size_t thread_count) {
+    return FindMaxFlowParallelPushRelabel(source, target, graph.GetView(), thread_count);
+}
+
+Capacity FindMaxFlowParallelPushRelabel(size_t source, size_t target,
+                                        const CsrGraphView<Capacity>& graph,
+                                        size_t thread_count) {
+    FlowNetwork network = MakeFlowNetwork(graph);
+    return ParallelPushRelabelFinder(&network, thread_count).Find(source, target);
+}
+
+}  // namespace push_relabel
@@ -0,0 +1,302 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+
+#include "Dinic.h"
+
+// INTERFACE
+
+namespace push_relabel {
+
+using dinic::Capacity;
+using dinic::Graph;
+using dinic::FlowNetwork;
+using dinic::MakeFlowNetwork;
+
+// Highest-label push-relabel with the gap heuristic and periodic global relabeling. Only the
+// first phase is run: the network is left with a maximum preflow, i.e. the flow into target is
+// maximal but excess may remain in vertexes which can not reach target.
+class MaxFlowPushRelabelFinder;
+
+Capacity FindMaxFlowPushRelabel(size_t source, size_t target, const Graph& graph);
+
+Capacity FindMaxFlowPushRelabel(size_t source, size_t target, const CsrGraph<Capacity>& graph);
+
+Capacity FindMaxFlowPushRelabel(size_t source, size_t target, const CsrGraphView<Capacity>& graph);
+
+// pair represents edge (from -> to); the cut may differ from FindMinFlowEdgeCut when there are
+// several minimum cuts, this one is the closest to target
+std::vector<std::pair<size_t, size_t>> FindMinFlowEdgeCutPushRelabel(size_t source, size_t target,
+                                                                     const Graph& graph,
+                                                                     Capacity* flow);
+
+// IMPLEMENTATION
+
+class MaxFlowPushRelabelFinder {
+public:
+    explicit MaxFlowPushRelabelFinder(FlowNetwork* network)
+        : network_(*network),
+          vertex_count_(network->VertexCount()),
+          heights_(vertex_count_),
+          excesses_(vertex_count_),
+          current_arcs_(vertex_count_),
+          layers_(vertex_count_),
+          layer_positions_(vertex_count_),
+          active_(vertex_count_) {
+        network_.PrepareAdjacency();
+    }
+
+    Capacity Find(size_t source, size_t target) {
+        if (source == target) {
+            return 0;
+        }
+        source_ = source;
+        target_ = target;
+        std::fill(excesses_.begin(), excesses_.end(), 0);
+
+        const std::vector<size_t>& adjacent_edges = network_.GetAdjacentEdges();
+        for (size_t arc = network_.GetAdjacencyBegin(source_);
+             arc < network_.GetAdjacencyEnd(source_); ++arc) {
+            size_t edge = adjacent_edges[arc];
+            Capacity capacity = network_.GetCapacity(edge);
+            if (capacity > 0) {
+                network_.Push(edge, capacity);
+                excesses_[network_.GetTo(edge)] += capacity;
+                excesses_[source_] -= capacity;
+            }
+        }
+
+        GlobalRelabel();
+        while (highest_active_ != kNoHeight) {
+            std::vector<size_t>& bucket = active_[highest_active_];
+            if (bucket.empty()) {
+                --highest_active_;
+                continue;
+            }
+            size_t vertex = bucket.back();
+            bucket.pop_back();
+            // entries left behind by the gap heuristic and global relabeling
+            if (heights_[vertex] != highest_active_ || excesses_[vertex] == 0) {
+                continue;
+            }
+            Discharge(vertex);
+            if (work_since_global_relabel_ > GetGlobalRelabelThreshold()) {
+                GlobalRelabel();
+            }
+        }
+        // makes heights exact, so IsOnSourceSide describes the final residual network
+        GlobalRelabel();
+        return excesses_[target_];
+    }
+
+    // whether @vertex can not reach target in the residual network after Find
+    bool IsOnSourceSide(size_t vertex) const {
+        return heights_[vertex] >= vertex_count_;
+    }
+
+private:
+    static constexpr size_t kNoHeight = SIZE_MAX;
+    // the usual constants of Cherkassky and Goldberg
+    static constexpr size_t kRelabelWork = 12;
+    static constexpr size_t kGlobalRelabelVertexFactor = 6;
+
+    FlowNetwork& network_;
+    size_t vertex_count_;
+    size_t source_ = 0;
+    size_t target_ = 0;
+
+    std::vector<size_t> heights_;
+    std::vector<Capacity> excesses_;
+    std::vector<size_t> current_arcs_;
+
+    // layers_[h] are all vertexes of height h < vertex_count_, needed by the gap heuristic
+    std::vector<std::vector<size_t>> layers_;
+    std::vector<size_t> layer_positions_;
+    size_t highest_layer_ = 0;
+
+    // active_[h] are vertexes of height h with positive excess, possibly with stale entries
+    std::vector<std::vector<size_t>> active_;
+    size_t highest_active_ = kNoHeight;
+
+    size_t work_since_global_relabel_ = 0;
+    std::vector<size_t> vertex_queue_;
+
+    size_t GetGlobalRelabelThreshold() const {
+        return kGlobalRelabelVertexFactor * vertex_count_ + network_.EdgeCount() / 2;
+    }
+
+    void AddToLayer(size_t vertex) {
+        size_t height = heights_[vertex];
+        layer_positions_[vertex] = layers_[height].size();
+        layers_[height].push_back(vertex);
+        highest_layer_ = std::max(highest_layer_, height);
+    }
+
+    void RemoveFromLayer(size_t vertex) {
+        std::vector<size_t>& layer = layers_[heights_[vertex]];
+        size_t last = layer.back();
+        layer[layer_positions_[vertex]] = last;
+        layer_positions_[last] = layer_positions_[vertex];
+        layer.pop_back();
+    }
+
+    void Activate(size_t vertex) {
+        size_t height = heights_[vertex];
+        active_[height].push_back(vertex);
+        if (highest_active_ == kNoHeight || height > highest_active_) {
+            highest_active_ = height;
+        }
+    }
+
+    // pushes excess of @vertex along admissible edges, relabels when they run out
+    void Discharge(size_t vertex) {
+        const std::vector<size_t>& adjacent_edges = network_.GetAdjacentEdges();
+        while (excesses_[vertex] > 0) {
+            size_t& arc = current_arcs_[vertex];
+            for (; arc < network_.GetAdjacencyEnd(vertex) && excesses_[vertex] > 0; ++arc) {
+                size_t edge = adjacent_edges[arc];
+                size_t to = network_.GetTo(edge);
+                Capacity capacity = network_.GetCapacity(edge);
+                if (capacity == 0 || heights_[to] + 1 != heights_[vertex]) {
+                    continue;
+                }
+                Capacity flow = std::min(excesses_[vertex], capacity);
+                network_.Push(edge, flow);
+                excesses_[vertex] -= flow;
+                if (excesses_[to] == 0 && to != target_) {
+                    Activate(to);
+                }
+                excesses_[to] += flow;
+                if (excesses_[vertex] == 0) {
+                    return;
+                }
+            }
+            size_t old_height = heights_[vertex];
+            if (layers_[old_height].size() == 1) {
+                ApplyGap(old_height);
+                return;
+            }
+            Relabel(vertex);
+            if (heights_[vertex] >= vertex_count_) {
+                return;
+            }
+        }
+    }
+
+    void Relabel(size_t vertex) {
+        const std::vector<size_t>& adjacent_edges = network_.GetAdjacentEdges();
+        work_since_global_relabel_ += kRelabelWork;
+        RemoveFromLayer(vertex);
+        size_t new_height = vertex_count_;
+        for (size_t arc = network_.GetAdjacencyBegin(vertex);
+             arc < network_.GetAdjacencyEnd(vertex); ++arc) {
+            size_t edge = adjacent_edges[arc];
+            ++work_since_global_relabel_;
+            if (network_.GetCapacity(edge) > 0) {
+                new_height = std::min(new_height, heights_[network_.GetTo(edge)] + 1);
+            }
+        }
+        heights_[vertex] = new_height;
+        current_arcs_[vertex] = network_.GetAdjacencyBegin(vertex);
+        if (new_height < vertex_count_) {
+            AddToLayer(vertex);
+        }
+    }
+
+    // nothing at or above an empty height can reach target any more
+    void ApplyGap(size_t height) {
+        for (size_t layer = height; layer <= highest_layer_; ++layer) {
+            for (size_t vertex : layers_[layer]) {
+                heights_[vertex] = vertex_count_;
+            }
+            layers_[layer].clear();
+        }
+        highest_layer_ = height == 0 ? 0 : height - 1;
+    }
+
+    // exact heights by a backward BFS from target over edges with positive residual capacity
+    void GlobalRelabel() {
+        work_since_global_relabel_ = 0;
+        std::fill(heights_.begin(), heights_.end(), vertex_count_);
+        for (size_t height = 0; height <= highest_layer_; ++height) {
+            layers_[height].clear();
+        }
+        for (size_t height = 0; highest_active_ != kNoHeight && height <= highest_active_;
+             ++height) {
+            active_[height].clear();
+        }
+        highest_layer_ = 0;
+        highest_active_ = kNoHeight;
+
+        const std::vector<size_t>& adjacent_edges = network_.GetAdjacentEdges();
+        heights_[target_] = 0;
+        vertex_queue_.assign(1, target_);
+        for (size_t index = 0; index < vertex_queue_.size(); ++index) {
+            size_t vertex = vertex_queue_[index];
+            current_arcs_[vertex] = network_.GetAdjacencyBegin(vertex);
+            AddToLayer(vertex);
+            if (excesses_[vertex] > 0 && vertex != target_) {
+                Activate(vertex);
+            }
+            for (size_t arc = network_.GetAdjacencyBegin(vertex);
+                 arc < network_.GetAdjacencyEnd(vertex); ++arc) {
+                size_t edge = adjacent_edges[arc];
+                size_t from = network_.GetTo(edge);
+                if (from == source_ || heights_[from] != vertex_count_ ||
+                    network_.GetCapacity(edge ^ 1) == 0) {
+                    continue;
+                }
+                heights_[from] = heights_[vertex] + 1;
+                vertex_queue_.push_back(from);
+            }
+        }
+    }
+};
+
+Capacity FindMaxFlowPushRelabel(size_t source, size_t target, const Graph& graph) {
+    FlowNetwork network = MakeFlowNetwork(graph);
+    return MaxFlowPushRelabelFinder(&network).Find(source, target);
+}
+
+Capacity FindMaxFlowPushRelabel(size_t source, size_t target, const CsrGraph<Capacity>& graph) {
+    return FindMaxFlowPushRelabel(source, target, graph.GetView());
+}
+
+Capacity FindMaxFlowPushRelabel(size_t source, size_t target,
+                                const CsrGraphView<Capacity>& graph) {
+    FlowNetwork network = MakeFlowNetwork(graph);
+    return MaxFlowPushRelabelFinder(&network).Find(source, target);
+}
+
+std::vector<std::pair<size_t, size_t>> FindMinFlowEdgeCutPushRelabel(size_t source, size_t target,
+                                                                     const Graph& graph,
+                                                                     Capacity* flow) {
+    FlowNetwork network = MakeFlowNetwork(graph);
+    MaxFlowPushRelabelFinder finder(&network);
+    Capacity max_flow = finder.Find(source, target);
+    *flow = max_flow;
+
+    Capacity edge_cut_flow = 0;
+    std::vector<std::pair<size_t, size_t>> cut_edges;
+    for (size_t vertex = 0; vertex < graph.size(); ++vertex) {
+        if (!finder.IsOnSourceSide(vertex)) {
+            continue;
+        }
+        for (const auto& [to, capacity] : graph[vertex]) {
+            if (finder.IsOnSourceSide(to)) {
+                continue;
+            }
+            edge_cut_flow += capacity;
+            cut_edges.emplace_back(vertex, to);
+        }
+    }
+    assert(max_flow == edge_cut_flow);
+    return cut_edges;
+}
+
+}  // namespace push_relabel
+
+using namespace push_relabel;
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <utility>
+#include <limits>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+// INTERFACE
+
+// Monotone min-heap for unsigned integer keys: every pushed key must be not less than
+// the last popped one (which always holds for Dijkstra with non-negative weights).
+// Push is O(1), Pop is amortized O(log C), where C is the maximal key difference.
+template <class Value, class Key = uint64_t>
+class RadixHeap;
+
+// IMPLEMENTATION
+
+template <class Value, class Key>
+class RadixHeap {
+public:
+    static_assert(std::is_unsigned_v<Key> && std::numeric_limits<Key>::digits <= 64);
+
+    void Push(Key key, Value value) {
+        assert(key >= last_key_);
+        buckets_[GetBucket(key)].emplace_back(key, std::move(value));
+        ++size_;
+    }
+
+    const std::pair<Key, Value>& Top() {
+        Normalize();
+        return buckets_[0].back();
+    }
+
+    void Pop() {
+        Normalize();
+        buckets_[0].pop_back();
+        --size_;
+    }
+
+    bool Empty() const {
+        return size_ == 0;
+    }
+
+    size_t Size() const {
+        return size_;
+    }
+
+private:
+    static constexpr size_t kBucketCount = std::numeric_limits<Key>::digits + 1;
+
+    std::array<std::vector<std::pair<Key, Value>>, kBucketCount> buckets_;
+    Key last_key_ = 0;
+    size_t size_ = 0;
+
+    // bucket i > 0 holds keys whose highest bit differing from last_key_ is bit (i - 1)
+    size_t GetBucket(Key key) const {
+        unsigned long long difference = key ^ last_key_;
+        return difference == 0 ? 0 : 64 - __builtin_clzll(difference);
+    }
+
+    void Normalize() {
+        assert(size_ != 0);
+        if (!buckets_[0].empty()) {
+            return;
+        }
+        size_t bucket = 1;
+        while (buckets_[bucket].empty()) {
+            ++bucket;
+        }
+        last_key_ = buckets_[bucket].front().first;
+        for (const auto& [key, value] : buckets_[bucket]) {
+            last_key_ = std::min(last_key_, key);
+        }
+        for (auto& element : buckets_[bucket]) {
+            buckets_[GetBucket(element.first)].push_back(std::move(element));
+        }
+        buckets_[bucket].clear();
+    }
+};
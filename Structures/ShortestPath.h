@@ -0,0 +1,317 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <tuple>
+#include <functional>
+#include <algorithm>
+#include <cassert>
+
+#include "CsrGraph.h"
+#include "Dijkstra.h"
+
+// INTERFACE
+
+namespace dijkstra {
+
+struct ShortestPath {
+    // kInfDistance if finish is unreachable
+    Distance distance;
+    // [start, ..., finish], empty if finish is unreachable or the path was not requested
+    std::vector<Vertex> path;
+};
+
+Graph MakeReversedGraph(const Graph& graph);
+
+CsrGraph<Distance> MakeReversedGraph(const CsrGraph<Distance>& graph);
+
+// point-to-point Dijkstra, stops as soon as @finish_vertex is proved
+ShortestPath FindShortestPath(const Graph& graph, Vertex start_vertex, Vertex finish_vertex,
+                              bool restore_path = false);
+
+ShortestPath FindShortestPath(const CsrGraph<Distance>& graph, Vertex start_vertex,
+                              Vertex finish_vertex, bool restore_path = false);
+
+// searches from both ends at once, @reversed_graph is MakeReversedGraph(@graph)
+ShortestPath FindShortestPathBidirectional(const Graph& graph, const Graph& reversed_graph,
+                                           Vertex start_vertex, Vertex finish_vertex,
+                                           bool restore_path = false);
+
+ShortestPath FindShortestPathBidirectional(const CsrGraph<Distance>& graph,
+                                           const CsrGraph<Distance>& reversed_graph,
+                                           Vertex start_vertex, Vertex finish_vertex,
+                                           bool restore_path = false);
+
+// @heuristic(vertex) must be admissible, i.e. not greater than the distance from vertex to
+// @finish_vertex; a consistent heuristic never reopens already proved vertexes
+template <class Heuristic>
+ShortestPath FindShortestPathAStar(const Graph& graph, Vertex start_vertex, Vertex finish_vertex,
+                                   Heuristic heuristic, bool restore_path = false);
+
+template <class Heuristic>
+ShortestPath FindShortestPathAStar(const CsrGraph<Distance>& graph, Vertex start_vertex,
+                                   Vertex finish_vertex, Heuristic heuristic,
+                                   bool restore_path = false);
+
+// IMPLEMENTATION
+
+std::vector<Vertex> RestorePath(const std::vector<Vertex>& parents, Vertex start_vertex,
+                                Vertex finish_vertex) {
+    std::vector<Vertex> path;
+    for (Vertex vertex = finish_vertex; vertex != start_vertex; vertex = parents[vertex]) {
+        assert(parents[vertex] != kNoVertex);
+        path.push_back(vertex);
+    }
+    path.push_back(start_vertex);
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+Graph MakeReversedGraph(const Graph& graph) {
+    Graph reversed_graph(graph.size());
+    for (Vertex from = 0; from < graph.size(); ++from) {
+        for (const auto& [to, weight] : graph[from]) {
+            reversed_graph[to][from] = weight;
+        }
+    }
+    return reversed_graph;
+}
+
+CsrGraph<Distance> MakeReversedGraph(const CsrGraph<Distance>& graph) {
+    std::vector<CsrEdge<Distance>> reversed_edges;
+    reversed_edges.reserve(graph.EdgeCount());
+    for (Vertex from = 0; from < graph.size(); ++from) {
+        for (const auto& [to, weight] : graph[from]) {
+            reversed_edges.push_back({to, from, weight});
+        }
+    }
+    return MakeCsrGraph(graph.size(), reversed_edges);
+}
+
+template <class GraphType>
+ShortestPath FindShortestPathDijkstra(const GraphType& graph, Vertex start_vertex,
+                                      Vertex finish_vertex, bool restore_path) {
+    std::vector<Vertex> parents;
+    std::vector<Distance> distances = FindDistancesDijkstra(graph, start_vertex, finish_vertex,
+                                                            restore_path ? &parents : nullptr);
+    ShortestPath result{distances[finish_vertex], {}};
+    if (restore_path && result.distance != kInfDistance) {
+        result.path = RestorePath(parents, start_vertex, finish_vertex);
+    }
+    return result;
+}
+
+// one half of the bidirectional search
+template <class GraphType>
+class DijkstraSearchFront {
+public:
+    DijkstraSearchFront(const GraphType& graph, Vertex start_vertex)
+        : graph_(graph),
+          distances_(graph.size(), kInfDistance),
+          parents_(graph.size(), kNoVertex),
+          proved_(graph.size()),
+          heap_(graph.size()) {
+        distances_[start_vertex] = 0;
+        heap_.Push(start_vertex, 0);
+    }
+
+    bool Empty() {
+        return heap_.Empty();
+    }
+
+    Distance GetMinDistance() {
+        return heap_.TopKey();
+    }
+
+    // proves the closest vertex and relaxes its edges, calls @on_update for every vertex
+    // whose distance has decreased; returns the proved vertex
+    template <class Callback>
+    Vertex ProveMinVertex(Callback on_update) {
+        Vertex vertex = heap_.Top();
+        heap_.Pop();
+        proved_[vertex] = true;
+        for (const auto& [target_vertex, weight] : graph_[vertex]) {
+            if (proved_[target_vertex]) {
+                continue;
+            }
+            Distance new_distance = distances_[vertex] + weight;
+            if (!heap_.PushOrDecreaseKey(target_vertex, new_distance)) {
+                continue;
+            }
+            distances_[target_vertex] = new_distance;
+            parents_[target_vertex] = vertex;
+            on_update(target_vertex);
+        }
+        return vertex;
+    }
+
+    Distance GetDistance(Vertex vertex) const {
+        return distances_[vertex];
+    }
+
+    const std::vector<Vertex>& GetParents() const {
+        return parents_;
+    }
+
+private:
+    const GraphType& graph_;
+    std::vector<Distance> distances_;
+    std::vector<Vertex> parents_;
+    std::vector<bool> proved_;
+    DijkstraHeap heap_;
+};
+
+template <class GraphType>
+class BidirectionalDijkstraFinder {
+public:
+    BidirectionalDijkstraFinder(const GraphType& graph, const GraphType& reversed_graph,
+                                Vertex start_vertex, Vertex finish_vertex)
+        : forward_(graph, start_vertex),
+          backward_(reversed_graph, finish_vertex),
+          start_vertex_(start_vertex),
+          finish_vertex_(finish_vertex) {
+    }
+
+    ShortestPath Find(bool restore_path) {
+        // the search is over once no path through unproved vertexes can beat the best one
+        while (!forward_.Empty() && !backward_.Empty()) {
+            Distance forward_min = forward_.GetMinDistance();
+            Distance backward_min = backward_.GetMinDistance();
+            if (best_distance_ != kInfDistance && forward_min + backward_min >= best_distance_) {
+                break;
+            }
+            if (forward_min <= backward_min) {
+                Step(&forward_);
+            } else {
+                Step(&backward_);
+            }
+        }
+
+        ShortestPath result{best_distance_, {}};
+        if (restore_path && best_distance_ != kInfDistance) {
+            result.path = RestorePath(forward_.GetParents(), start_vertex_, meeting_vertex_);
+            for (Vertex vertex = meeting_vertex_; vertex != finish_vertex_;) {
+                vertex = backward_.GetParents()[vertex];
+                result.path.push_back(vertex);
+            }
+        }
+        return result;
+    }
+
+private:
+    DijkstraSearchFront<GraphType> forward_;
+    DijkstraSearchFront<GraphType> backward_;
+    Vertex start_vertex_;
+    Vertex finish_vertex_;
+    Distance best_distance_ = kInfDistance;
+    Vertex meeting_vertex_ = kNoVertex;
+
+    void Step(DijkstraSearchFront<GraphType>* front) {
+        auto try_meet_at = [this](Vertex vertex) {
+            Distance forward_distance = forward_.GetDistance(vertex);
+            Distance backward_distance = backward_.GetDistance(vertex);
+            if (forward_distance == kInfDistance || backward_distance == kInfDistance) {
+                return;
+            }
+            if (best_distance_ == kInfDistance ||
+                forward_distance + backward_distance < best_distance_) {
+                best_distance_ = forward_distance + backward_distance;
+                meeting_vertex_ = vertex;
+            }
+        };
+        try_meet_at(front->ProveMinVertex(try_meet_at));
+    }
+};
+
+template <class GraphType, class Heuristic>
+class AStarFinder {
+public:
+    AStarFinder(const GraphType& graph, Heuristic heuristic)
+        : graph_(graph),
+          heuristic_(std::move(heuristic)),
+          distances_(graph.size(), kInfDistance),
+          parents_(graph.size(), kNoVertex) {
+    }
+
+    ShortestPath Find(Vertex start_vertex, Vertex finish_vertex, bool restore_path) {
+        // (distance + heuristic, distance, vertex); outdated entries are skipped when popped
+        using Entry = std::tuple<Distance, Distance, Vertex>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<>> queue;
+
+        distances_[start_vertex] = 0;
+        queue.emplace(heuristic_(start_vertex), 0, start_vertex);
+        while (!queue.empty()) {
+            auto [estimate, distance, vertex] = queue.top();
+            queue.pop();
+            if (distance != distances_[vertex]) {
+                continue;
+            }
+            if (vertex == finish_vertex) {
+                break;
+            }
+            for (const auto& [target_vertex, weight] : graph_[vertex]) {
+                Distance new_distance = distance + weight;
+                if (distances_[target_vertex] != kInfDistance &&
+                    distances_[target_vertex] <= new_distance) {
+                    continue;
+                }
+                distances_[target_vertex] = new_distance;
+                parents_[target_vertex] = vertex;
+                queue.emplace(new_distance + heuristic_(target_vertex), new_distance, target_vertex);
+            }
+        }
+
+        ShortestPath result{distances_[finish_vertex], {}};
+        if (restore_path && result.distance != kInfDistance) {
+            result.path = RestorePath(parents_, start_vertex, finish_vertex);
+        }
+        return result;
+    }
+
+private:
+    const GraphType& graph_;
+    Heuristic heuristic_;
+    std::vector<Distance> distances_;
+    std::vector<Vertex> parents_;
+};
+
+ShortestPath FindShortestPath(const Graph& graph, Vertex start_vertex, Vertex finish_vertex,
+                              bool restore_path) {
+    return FindShortestPathDijkstra(graph, start_vertex, finish_vertex, restore_path);
+}
+
+ShortestPath FindShortestPath(const CsrGraph<Distance>& graph, Vertex start_vertex,
+                              Vertex finish_vertex, bool restore_path) {
+    return FindShortestPathDijkstra(graph, start_vertex, finish_vertex, restore_path);
+}
+
+ShortestPath FindShortestPathBidirectional(const Graph& graph, const Graph& reversed_graph,
+                                           Vertex start_vertex, Vertex finish_vertex,
+                                           bool restore_path) {
+    return BidirectionalDijkstraFinder(graph, reversed_graph, start_vertex, finish_vertex)
+        .Find(restore_path);
+}
+
+ShortestPath FindShortestPathBidirectional(const CsrGraph<Distance>& graph,
+                                           const CsrGraph<Distance>& reversed_graph,
+                                           Vertex start_vertex, Vertex finish_vertex,
+                                           bool restore_path) {
+    return BidirectionalDijkstraFinder(graph, reversed_graph, start_vertex, finish_vertex)
+        .Find(restore_path);
+}
+
+template <class Heuristic>
+ShortestPath FindShortestPathAStar(const Graph& graph, Vertex start_vertex, Vertex finish_vertex,
+                                   Heuristic heuristic, bool restore_path) {
+    return AStarFinder<Graph, Heuristic>(graph, std::move(heuristic))
+        .Find(start_vertex, finish_vertex, restore_path);
+}
+
+template <class Heuristic>
+ShortestPath FindShortestPathAStar(const CsrGraph<Distance>& graph, Vertex start_vertex,
+                                   Vertex finish_vertex, Heuristic heuristic, bool restore_path) {
+    return AStarFinder<CsrGraph<Distance>, Heuristic>(graph, std::move(heuristic))
+        .Find(start_vertex, finish_vertex, restore_path);
+}
+
+}  // namespace dijkstra
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <fstream>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+
+#include "ConnectedComponents.h"
+#include "CsrGraphFile.h"
+#include "DisjointSetUnion.h"
+
+// INTERFACE
+
+namespace connected_components {
+
+// Counters of one pass over an edge stream.
+struct StreamingStats;
+
+// Connected components of an edge stream which is never stored: every edge joins the sets of
+// its ends in a DisjointSetUnion, so the memory is O(V) for any number of edges, and every edge
+// is read once. The vertex count is fixed in advance. Edges may come in any direction and
+// repeat; the labels are the same as FindComponentLabels gives for the undirected graph.
+class StreamingComponentFinder;
+
+// Text edge list: pairs of vertex numbers separated by whitespace, usually one pair a line;
+// the rest of a line after '#' or '%' is a comment. Read in chunks of a fixed size, throws
+// std::runtime_error if the file can not be read or is malformed.
+ComponentLabels FindComponentLabelsFromTextFile(const std::string& path, size_t vertex_count,
+                                                StreamingStats* stats = nullptr);
+
+// Binary CSR file of SaveCsrGraph, mapped by MappedCsrGraph and scanned in the order of its
+// edges; the edges are taken as undirected, so a directed graph gives its weak components.
+ComponentLabels FindComponentLabelsFromCsrFile(const std::string& path,
+                                               StreamingStats* stats = nullptr);
+
+// IMPLEMENTATION
+
+struct StreamingStats {
+    size_t edge_count = 0;
+    // read from the file
+    size_t byte_count = 0;
+    double seconds = 0;
+
+    double GetEdgesPerSecond() const {
+        return seconds > 0 ? edge_count / seconds : 0;
+    }
+};
+
+class StreamingComponentFinder {
+public:
+    static constexpr size_t kNoLabel = SIZE_MAX;
+
+    explicit StreamingComponentFinder(size_t vertex_count)
+        : vertex_count_(vertex_count), sets_(vertex_count) {
+    }
+
+    void AddEdge(size_t from, size_t to) {
+        if (from >= vertex_count_ || to >= vertex_count_) {
+            ThrowOutOfRange(from, to);
+        }
+        sets_.UnionSets(from, to);
+        ++edge_count_;
+    }
+
+    // parses the next piece of a text edge list, a number or a comment may continue
+    // in the next piece
+    void AddText(const char* data, size_t size) {
+        for (const char* end = data + size; data != end; ++data) {
+            char symbol = *data;
+            if (is_in_comment_) {
+                is_in_comment_ = symbol != '\n';
+            } else if (symbol >= '0' && symbol <= '9') {
+                size_t digit = symbol - '0';
+                if (number_ > (SIZE_MAX - digit) / 10) {
+                    throw std::runtime_error("vertex number is too large");
+                }
+                number_ = number_ * 10 + digit;
+                is_in_number_ = true;
+            } else if (symbol == ' ' || symbol == '\t' || symbol == '\n' || symbol == '\r' ||
+                       symbol == '#' || symbol == '%') {
+                EndNumber();
+                is_in_comment_ = symbol == '#' || symbol == '%';
+            } else {
+                throw std::runtime_error(std::string("unexpected symbol '") + symbol +
+                                         "' in edge list");
+            }
+        }
+    }
+
+    // ends the text edge list, must come before GetLabels; the last number may have no
+    // separator after it, and parsed edges are joined in batches
+    void FinishText() {
+        EndNumber();
+        AddParsedEdges();
+        if (has_edge_start_) {
+            throw std::runtime_error("edge list has an odd count of vertex numbers");
+        }
+    }
+
+    size_t GetEdgeCount() const {
+        return edge_count_;
+    }
+
+    size_t GetComponentCount() const {
+        return sets_.GetSetsCount();
+    }
+
+    // the label of a root is set by the first vertex of its set, which is the smallest one;
+    // a root belongs to its own set, so labels serve as the map from roots to components
+    ComponentLabels GetLabels() {
+        ComponentLabels result;
+        result.labels.assign(vertex_count_, kNoLabel);
+        result.sizes.reserve(sets_.GetSetsCount());
+        for (size_t vertex = 0; vertex < vertex_count_; ++vertex) {
+            size_t root = sets_.FindSet(vertex);
+            if (result.labels[root] == kNoLabel) {
+                result.labels[root] = result.sizes.size();
+                result.sizes.push_back(0);
+            }
+            result.labels[vertex] = result.labels[root];
+            ++result.sizes[result.labels[vertex]];
+        }
+        return result;
+    }
+
+private:
+    size_t vertex_count_;
+    DisjointSetUnion<size_t> sets_;
+    size_t edge_count_ = 0;
+
+    // parsed edges are joined in batches: a tight loop of unions lets the CPU wait for
+    // the cache misses of several of them at once, between the parsing it waits for each
+    static constexpr size_t kParsedBatchSize = 1024;
+    std::vector<std::pair<size_t, size_t>> parsed_edges_;
+
+    // state of the text parser between pieces
+    size_t number_ = 0;
+    bool is_in_number_ = false;
+    bool is_in_comment_ = false;
+    size_t edge_start_ = 0;
+    bool has_edge_start_ = false;
+
+    // kept out of AddEdge, so the string building does not get into the loops of unions
+    [[noreturn]] void ThrowOutOfRange(size_t from, size_t to) const {
+        throw std::runtime_error("edge (" + std::to_string(from) + ", " + std::to_string(to) +
+                                 ") is out of " + std::to_string(vertex_count_) + " vertexes");
+    }
+
+    void AddParsedEdges() {
+        for (const auto& [from, to] : parsed_edges_) {
+            AddEdge(from, to);
+        }
+        parsed_edges_.clear();
+    }
+
+    void EndNumber() {
+        if (!is_in_number_) {
+            return;
+        }
+        if (has_edge_start_) {
+            parsed_edges_.emplace_back(edge_start_, number_);
+            if (parsed_edges_.size() == kParsedBatchSize) {
+                AddParsedEdges();
+            }
+        } else {
+            edge_start_ = number_;
+        }
+        has_edge_start_ = !has_edge_start_;
+        number_ = 0;
+        is_in_number_ = false;
+    }
+};
+
+ComponentLabels FindComponentLabelsFromTextFile(const std::string& path, size_t vertex_count,
+                                                StreamingStats* stats) {
+    static constexpr size_t kChunkSize = 1 << 20;
+
+    auto start = std::chrono::steady_clock::now();
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("can not open " + path);
+    }
+    StreamingComponentFinder finder(vertex_count);
+    std::vector<char> chunk(kChunkSize);
+    size_t byte_count = 0;
+    while (in) {
+        in.read(chunk.data(), chunk.size());
+        finder.AddText(chunk.data(), in.gcount());
+        byte_count += in.gcount();
+    }
+    if (in.bad()) {
+        throw std::runtime_error("can not read " + path);
+    }
+    finder.FinishText();
+    ComponentLabels result = finder.GetLabels();
+    if (stats) {
+        stats->edge_count = finder.GetEdgeCount();
+        stats->byte_count = byte_count;
+        stats->seconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return result;
+}
+
+ComponentLabels FindComponentLabelsFromCsrFile(const std::string& path, StreamingStats* stats) {
+    auto start = std::chrono::steady_clock::now();
+    MappedCsrGraph<> graph(path);
+    const CsrGraphView<>& view = graph.GetView();
+    StreamingComponentFinder finder(view.size());
+    for (size_t vertex = 0; vertex < view.size(); ++vertex) {
+        for (size_t neighbor : view[vertex]) {
+            finder.AddEdge(vertex, neighbor);
+        }
+    }
+    ComponentLabels result = finder.GetLabels();
+    if (stats) {
+        stats->edge_count = finder.GetEdgeCount();
+        stats->byte_count = sizeof(CsrFileHeader) + 8 * (view.size() + 1 + view.EdgeCount());
+        stats->seconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return result;
+}
+
+}  // namespace connected_components
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <string>
+#include <stdexcept>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Read-only memory mapping of a whole file, pages are shared with the page cache
+// and other processes mapping the same file.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        int descriptor = open(path.c_str(), O_RDONLY);
+        if (descriptor == -1) {
+            throw std::runtime_error("can not open " + path);
+        }
+        struct stat file_stat;
+        if (fstat(descriptor, &file_stat) == -1) {
+            close(descriptor);
+            throw std::runtime_error("can not stat " + path);
+        }
+        size_ = file_stat.st_size;
+        if (size_ != 0) {
+            void* data = mmap(nullptr, size_, PROT_READ, MAP_SHARED, descriptor, 0);
+            if (data == MAP_FAILED) {
+                close(descriptor);
+                throw std::runtime_error("can not mmap " + path);
+            }
+            data_ = static_cast<const char*>(data);
+        }
+        close(descriptor);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {
+    }
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        return *this;
+    }
+
+    ~MappedFile() {
+        if (data_) {
+            munmap(const_cast<char*>(data_), size_);
+        }
+    }
+
+    const char* Data() const {
+        return data_;
+    }
+
+    size_t Size() const {
+        return size_;
+    }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Expected size of a file made of sections whose lengths are read from the file itself, so
+// a crafted header can not make the sum wrap around and pass the size check.
+class FileSizeCounter {
+public:
+    explicit FileSizeCounter(size_t size = 0) : size_(size) {
+    }
+
+    // @count items of @item_size bytes
+    void Add(size_t count, size_t item_size) {
+        if (item_size != 0 && count > (SIZE_MAX - size_) / item_size) {
+            is_overflow_ = true;
+        } else if (!is_overflow_) {
+            size_ += count * item_size;
+        }
+    }
+
+    // pads the size up to a multiple of @alignment
+    void Align(size_t alignment) {
+        Add(1, (alignment - size_ % alignment) % alignment);
+    }
+
+    bool Matches(size_t size) const {
+        return !is_overflow_ && size_ == size;
+    }
+
+private:
+    size_t size_;
+    bool is_overflow_ = false;
+};
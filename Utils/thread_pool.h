@@ -0,0 +1,166 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <algorithm>
+
+// Fork-join pool: Run executes a task on every thread at once and waits for all of them.
+// The calling thread takes part as thread 0, so a pool of size 1 starts no threads at all.
+// ParallelFor spreads independent iterations with work stealing: every thread owns a range
+// of indexes and takes them from the front, an idle thread steals half of the largest range
+// from the back, so uneven iterations do not leave threads waiting.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t thread_count = std::thread::hardware_concurrency()) {
+        if (thread_count == 0) {
+            thread_count = 1;
+        }
+        for (size_t thread_index = 1; thread_index < thread_count; ++thread_index) {
+            workers_.emplace_back([this, thread_index] { WorkerLoop(thread_index); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_condition_.notify_all();
+        for (std::thread& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    size_t Size() const {
+        return workers_.size() + 1;
+    }
+
+    void Run(const std::function<void(size_t thread_index)>& task) {
+        if (workers_.empty()) {
+            task(0);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = &task;
+            running_count_ = workers_.size();
+            ++generation_;
+        }
+        start_condition_.notify_all();
+        task(0);
+        std::unique_lock<std::mutex> lock(mutex_);
+        finish_condition_.wait(lock, [this] { return running_count_ == 0; });
+    }
+
+    void ParallelFor(size_t count,
+                     const std::function<void(size_t index, size_t thread_index)>& task) {
+        size_t thread_count = std::min(Size(), std::max<size_t>(count, 1));
+        std::unique_ptr<IndexRange[]> ranges(new IndexRange[thread_count]);
+        for (size_t thread_index = 0; thread_index < thread_count; ++thread_index) {
+            ranges[thread_index].begin = count * thread_index / thread_count;
+            ranges[thread_index].end = count * (thread_index + 1) / thread_count;
+        }
+        Run([&](size_t thread_index) {
+            if (thread_index >= thread_count) {
+                return;
+            }
+            size_t index;
+            while (ranges[thread_index].PopFront(&index) ||
+                   StealHalf(ranges.get(), thread_count, thread_index, &index)) {
+                task(index, thread_index);
+            }
+        });
+    }
+
+private:
+    struct IndexRange {
+        std::mutex mutex;
+        size_t begin = 0;
+        size_t end = 0;
+
+        bool PopFront(size_t* index) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (begin == end) {
+                return false;
+            }
+            *index = begin++;
+            return true;
+        }
+
+        size_t Size() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return end - begin;
+        }
+    };
+
+    // moves the back half of the largest foreign range to @thread_index, returns its first index
+    static bool StealHalf(IndexRange* ranges, size_t thread_count, size_t thread_index,
+                          size_t* index) {
+        while (true) {
+            size_t victim = thread_index;
+            size_t victim_size = 0;
+            for (size_t other = 0; other < thread_count; ++other) {
+                size_t size = other == thread_index ? 0 : ranges[other].Size();
+                if (size > victim_size) {
+                    victim = other;
+                    victim_size = size;
+                }
+            }
+            if (victim_size == 0) {
+                return false;
+            }
+            size_t begin;
+            size_t end;
+            {
+                std::lock_guard<std::mutex> lock(ranges[victim].mutex);
+                size_t size = ranges[victim].end - ranges[victim].begin;
+                if (size == 0) {
+                    continue;
+                }
+                end = ranges[victim].end;
+                begin = end - (size + 1) / 2;
+                ranges[victim].end = begin;
+            }
+            std::lock_guard<std::mutex> lock(ranges[thread_index].mutex);
+            ranges[thread_index].begin = begin + 1;
+            ranges[thread_index].end = end;
+            *index = begin;
+            return true;
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable start_condition_;
+    std::condition_variable finish_condition_;
+    const std::function<void(size_t)>* task_ = nullptr;
+    size_t generation_ = 0;
+    size_t running_count_ = 0;
+    bool stop_ = false;
+
+    void WorkerLoop(size_t thread_index) {
+        size_t seen_generation = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            start_condition_.wait(lock, [&] { return stop_ || generation_ != seen_generation; });
+            if (stop_) {
+                return;
+            }
+            seen_generation = generation_;
+            const auto* task = task_;
+            lock.unlock();
+            (*task)(thread_index);
+            lock.lock();
+            if (--running_count_ == 0) {
+                finish_condition_.notify_one();
+            }
+        }
+    }
+};
@@ -0,0 +1,569 @@
+#include <cstdio>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <unordered_map>
+#include <algorithm>
+#include <cassert>
+
+#include "Structures/CsrGraph.h"
+#include "Structures/Dijkstra.h"
+#include "Structures/DeltaStepping.h"
+#include "Structures/Dinic.h"
+#include "Structures/PushRelabel.h"
+#include "Structures/ParallelPushRelabel.h"
+#include "Structures/EdmondsKarp.h"
+#include "Structures/Kuhn.h"
+#include "Structures/HopcroftKarp.h"
+#include "Structures/ParallelMatching.h"
+#include "Structures/ParallelConnectedComponents.h"
+
+// Reproduces the timings quoted in the history. "benchmark" runs every benchmark, "benchmark
+// name..." runs the named ones; baselines which take minutes run only with --slow.
+
+using Clock = std::chrono::steady_clock;
+
+template <class Task>
+double MeasureSeconds(const Task& task) {
+    Clock::time_point start = Clock::now();
+    task();
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// @edge_count random edges with weights in [0, @max_weight)
+CsrGraph<dijkstra::Distance> MakeRandomCsrGraph(size_t vertex_count, size_t edge_count,
+                                                dijkstra::Distance max_weight,
+                                                std::mt19937_64* rng) {
+    std::vector<CsrEdge<dijkstra::Distance>> edges;
+    edges.reserve(edge_count);
+    for (size_t edge = 0; edge < edge_count; ++edge) {
+        edges.push_back({(*rng)() % vertex_count, (*rng)() % vertex_count,
+                         static_cast<dijkstra::Distance>((*rng)() % max_weight)});
+    }
+    return MakeCsrGraph(vertex_count, edges);
+}
+
+void BenchmarkRadixHeap(bool) {
+    std::mt19937_64 rng(1);
+    auto graph = MakeRandomCsrGraph(1000000, 5000000, 100, &rng);
+    std::vector<dijkstra::Distance> heap_distances;
+    std::vector<dijkstra::Distance> radix_distances;
+    double heap_seconds = MeasureSeconds([&] {
+        heap_distances = dijkstra::Dijkstra(graph, 0, dijkstra::DijkstraQueue::kDaryHeap);
+    });
+    double radix_seconds = MeasureSeconds([&] {
+        radix_distances = dijkstra::Dijkstra(graph, 0, dijkstra::DijkstraQueue::kRadixHeap);
+    });
+    assert(heap_distances == radix_distances);
+    std::printf("radix_heap: csr 1M vertexes, 5M edges, weights < 100: d-ary heap %.2f s, "
+                "radix heap %.2f s\n",
+                heap_seconds, radix_seconds);
+}
+
+// the thread counts only show scaling on a machine with that many cores
+void BenchmarkDeltaStepping(bool) {
+    static constexpr dijkstra::Distance kDelta = 20;
+
+    std::mt19937_64 rng(1);
+    auto graph = MakeRandomCsrGraph(1000000, 5000000, 100, &rng);
+    std::vector<dijkstra::Distance> expected;
+    double dijkstra_seconds = MeasureSeconds([&] {
+        expected = dijkstra::Dijkstra(graph, 0, dijkstra::DijkstraQueue::kRadixHeap);
+    });
+    std::printf("delta_stepping: csr 1M vertexes, 5M edges, weights < 100: radix heap Dijkstra "
+                "%.2f s\n",
+                dijkstra_seconds);
+    for (size_t thread_count : {1, 2, 4, 8}) {
+        std::vector<dijkstra::Distance> distances;
+        double seconds = MeasureSeconds([&] {
+            distances = dijkstra::DeltaStepping(graph, 0, kDelta, thread_count);
+        });
+        assert(distances == expected);
+        std::printf("delta_stepping: delta %lld, %zu threads: %.2f s\n",
+                    static_cast<long long>(kDelta), thread_count, seconds);
+    }
+}
+
+// The binary heap which IndexedDaryHeap replaced in Dijkstra, kept as the baseline of
+// BenchmarkDaryHeap: node positions live in a hash map and nodes are swapped while sifting.
+class DijkstraVertexHeap {
+public:
+    struct Node {
+        dijkstra::Vertex index;
+        dijkstra::Distance distance;
+    };
+
+    void PushVertex(const Node& vertex) {
+        nodes_.push_back(vertex);
+        size_t node_index = nodes_.size() - 1;
+        vertexes_index_to_node_index_[vertex.index] = node_index;
+        ShiftUp(node_index);
+    }
+
+    Node GetMinVertex() {
+        return nodes_.front();
+    }
+
+    void PopMinVertex() {
+        SwapNodes(0, nodes_.size() - 1);
+        nodes_.pop_back();
+        if (nodes_.empty()) {
+            return;
+        }
+        ShiftDown(0);
+    }
+
+    void DecreaseDistance(dijkstra::Vertex vertex_index, dijkstra::Distance new_distance) {
+        size_t node_index = vertexes_index_to_node_index_.at(vertex_index);
+        assert(new_distance < nodes_[node_index].distance);
+        nodes_[node_index].distance = new_distance;
+        ShiftUp(node_index);
+    }
+
+    bool Empty() {
+        return nodes_.empty();
+    }
+
+    bool Contains(dijkstra::Vertex vertex_index) {
+        return vertexes_index_to_node_index_.find(vertex_index) !=
+               vertexes_index_to_node_index_.end();
+    }
+
+    Node GetVertex(dijkstra::Vertex vertex_index) {
+        return nodes_[vertexes_index_to_node_index_.at(vertex_index)];
+    }
+
+private:
+    std::vector<Node> nodes_;
+    std::unordered_map<int, size_t> vertexes_index_to_node_index_;
+
+    size_t GetParent(size_t index) {
+        return (index - 1) / 2;
+    }
+
+    void SwapNodes(size_t lhs, size_t rhs) {
+        std::swap(vertexes_index_to_node_index_.at(nodes_.at(lhs).index),
+                  vertexes_index_to_node_index_.at(nodes_.at(rhs).index));
+        std::swap(nodes_.at(lhs), nodes_.at(rhs));
+    }
+
+    bool ShouldSwap(size_t parent, size_t child) {
+        return nodes_[parent].distance > nodes_[child].distance;
+    }
+
+    void ShiftUp(size_t index) {
+        while (index != 0 && ShouldSwap(GetParent(index), index)) {
+            size_t parent_index = GetParent(index);
+            SwapNodes(index, parent_index);
+            index = parent_index;
+        }
+    }
+
+    void ShiftDown(size_t vertex) {
+        while ((2 * vertex + 1 < nodes_.size() && ShouldSwap(vertex, 2 * vertex + 1)) ||
+               (2 * vertex + 2 < nodes_.size() && ShouldSwap(vertex, 2 * vertex + 2))) {
+            size_t vertex_to_swap = 2 * vertex + 1;
+            if (2 * vertex + 2 < nodes_.size() && ShouldSwap(vertex_to_swap, 2 * vertex + 2)) {
+                vertex_to_swap = 2 * vertex + 2;
+            }
+            SwapNodes(vertex, vertex_to_swap);
+            vertex = vertex_to_swap;
+        }
+    }
+};
+
+// the Dijkstra loop as it was before IndexedDaryHeap
+std::vector<dijkstra::Distance> DijkstraVertexHeapDistances(const dijkstra::Graph& graph,
+                                                            dijkstra::Vertex start_vertex) {
+    std::vector<dijkstra::Distance> proved_distances(graph.size(), dijkstra::kInfDistance);
+    DijkstraVertexHeap reached_vertex_min_heap;
+    reached_vertex_min_heap.PushVertex({start_vertex, 0});
+    while (!reached_vertex_min_heap.Empty()) {
+        DijkstraVertexHeap::Node dijkstra_vertex = reached_vertex_min_heap.GetMinVertex();
+        reached_vertex_min_heap.PopMinVertex();
+        proved_distances[dijkstra_vertex.index] = dijkstra_vertex.distance;
+        for (const auto& [target_vertex, weight] : graph[dijkstra_vertex.index]) {
+            if (proved_distances[target_vertex] != dijkstra::kInfDistance) {
+                continue;
+            }
+            dijkstra::Distance new_distance = dijkstra_vertex.distance + weight;
+            if (!reached_vertex_min_heap.Contains(target_vertex)) {
+                reached_vertex_min_heap.PushVertex({target_vertex, new_distance});
+            } else if (new_distance < reached_vertex_min_heap.GetVertex(target_vertex).distance) {
+                reached_vertex_min_heap.DecreaseDistance(target_vertex, new_distance);
+            }
+        }
+    }
+    return proved_distances;
+}
+
+void BenchmarkDaryHeap(bool) {
+    std::mt19937_64 rng(8);
+    for (auto [vertex_count, degree] : {std::pair<size_t, size_t>{1000000, 5}, {5000, 1000}}) {
+        dijkstra::Graph graph(vertex_count);
+        for (size_t edge = 0; edge < vertex_count * degree; ++edge) {
+            graph[rng() % vertex_count][rng() % vertex_count] = rng() % 1000000;
+        }
+        std::vector<dijkstra::Distance> binary_distances;
+        std::vector<dijkstra::Distance> dary_distances;
+        double binary_seconds =
+            MeasureSeconds([&] { binary_distances = DijkstraVertexHeapDistances(graph, 0); });
+        double dary_seconds =
+            MeasureSeconds([&] { dary_distances = dijkstra::Dijkstra(graph, 0); });
+        assert(binary_distances == dary_distances);
+        std::printf("dary_heap: hash graph %zu vertexes x %zu edges: binary vertex heap %.2f s, "
+                    "indexed 4-ary heap %.2f s\n",
+                    vertex_count, degree, binary_seconds, dary_seconds);
+    }
+}
+
+// augmentation counts and timings of Edmonds-Karp and Dinic with and without capacity scaling,
+// both on the flat network
+void RunCapacityScaling(const char* name, const dinic::Graph& graph, size_t source,
+                        size_t target) {
+    const dinic::FlowNetwork network = dinic::MakeFlowNetwork(graph);
+    dinic::Capacity expected = -1;
+    for (bool capacity_scaling : {false, true}) {
+        dinic::FlowNetwork edmonds_karp_network = network;
+        edmonds_karp::FlowNetworkEdmondsKarpFinder edmonds_karp_finder(&edmonds_karp_network);
+        dinic::Capacity edmonds_karp_flow = 0;
+        double edmonds_karp_seconds = MeasureSeconds([&] {
+            edmonds_karp_flow = capacity_scaling
+                                    ? edmonds_karp_finder.FindWithCapacityScaling(source, target)
+                                    : edmonds_karp_finder.Find(source, target);
+        });
+        dinic::FlowNetwork dinic_network = network;
+        dinic::MaxFlowDinicFinder dinic_finder(&dinic_network);
+        dinic::Capacity dinic_flow = 0;
+        double dinic_seconds = MeasureSeconds([&] {
+            dinic_flow = capacity_scaling ? dinic_finder.FindWithCapacityScaling(source, target)
+                                          : dinic_finder.Find(source, target);
+        });
+        assert(edmonds_karp_flow == dinic_flow && (expected == -1 || expected == dinic_flow));
+        expected = dinic_flow;
+        std::printf("capacity_scaling: %s, %s: Edmonds-Karp %zu paths %.3f s, Dinic %zu paths "
+                    "%.3f s\n",
+                    name, capacity_scaling ? "scaling" : "plain",
+                    edmonds_karp_finder.GetAugmentationCount(), edmonds_karp_seconds,
+                    dinic_finder.GetAugmentationCount(), dinic_seconds);
+    }
+}
+
+void BenchmarkCapacityScaling(bool) {
+    std::mt19937_64 rng(17);
+    // log-uniform in [1, 1e9]
+    std::uniform_real_distribution<double> log_capacity(0, std::log(1e9));
+    auto make_capacity = [&] {
+        return static_cast<dinic::Capacity>(std::llround(std::exp(log_capacity(rng))));
+    };
+    {
+        static constexpr size_t kVertexCount = 5000;
+        dinic::Graph graph(kVertexCount);
+        for (size_t edge = 0; edge < 50000; ++edge) {
+            size_t from = rng() % kVertexCount;
+            size_t to = rng() % kVertexCount;
+            if (from != to) {
+                graph[from][to] = make_capacity();
+            }
+        }
+        RunCapacityScaling("random 5k/50k", graph, 0, 1);
+    }
+    {
+        static constexpr size_t kSide = 60;
+        dinic::Graph graph(kSide * kSide);
+        for (size_t row = 0; row < kSide; ++row) {
+            for (size_t column = 0; column < kSide; ++column) {
+                size_t vertex = row * kSide + column;
+                if (column + 1 < kSide) {
+                    graph[vertex][vertex + 1] = make_capacity();
+                    graph[vertex + 1][vertex] = make_capacity();
+                }
+                if (row + 1 < kSide) {
+                    graph[vertex][vertex + kSide] = make_capacity();
+                    graph[vertex + kSide][vertex] = make_capacity();
+                }
+            }
+        }
+        RunCapacityScaling("grid 60x60", graph, 0, kSide * kSide - 1);
+    }
+}
+
+// 100k vertexes and 1M random arcs from source 0 to target 1, which have 100 wide arcs each
+dinic::Graph MakeRandomFlowNetwork(std::mt19937_64* rng) {
+    static constexpr size_t kVertexCount = 100000;
+    dinic::Graph graph(kVertexCount);
+    for (size_t arc = 0; arc < 1000000; ++arc) {
+        size_t from = (*rng)() % kVertexCount;
+        size_t to = (*rng)() % kVertexCount;
+        if (from != to) {
+            graph[from][to] = 1 + (*rng)() % 1000;
+        }
+    }
+    for (size_t arc = 0; arc < 100; ++arc) {
+        graph[0][(*rng)() % kVertexCount] = 100000;
+        graph[(*rng)() % kVertexCount][1] = 100000;
+    }
+    return graph;
+}
+
+// Edmonds-Karp runs only when @with_edmonds_karp
+void RunMaxFlowFinders(const char* name, const dinic::Graph& graph, size_t source, size_t target,
+                       bool with_edmonds_karp) {
+    dinic::Capacity dinic_flow = 0;
+    dinic::Capacity push_relabel_flow = 0;
+    double dinic_seconds =
+        MeasureSeconds([&] { dinic_flow = dinic::FindMaxFlowDinic(source, target, graph); });
+    double push_relabel_seconds = MeasureSeconds([&] {
+        push_relabel_flow = push_relabel::FindMaxFlowPushRelabel(source, target, graph);
+    });
+    assert(dinic_flow == push_relabel_flow);
+    std::printf("push_relabel: %s: Dinic %.2f s, push-relabel %.2f s", name, dinic_seconds,
+                push_relabel_seconds);
+    if (with_edmonds_karp) {
+        edmonds_karp::Graph residual_network(graph.size());
+        for (size_t vertex = 0; vertex < graph.size(); ++vertex) {
+            for (const auto& [to, capacity] : graph[vertex]) {
+                residual_network[vertex][to] = capacity;
+            }
+        }
+        residual_network = edmonds_karp::MakeResidualNetwork(residual_network);
+        edmonds_karp::Capacity edmonds_karp_flow = 0;
+        double edmonds_karp_seconds = MeasureSeconds([&] {
+            edmonds_karp_flow =
+                edmonds_karp::FindMaxFlowEdmondsKarp(source, target, residual_network);
+        });
+        assert(edmonds_karp_flow == dinic_flow);
+        std::printf(", Edmonds-Karp %.2f s", edmonds_karp_seconds);
+    }
+    std::printf("\n");
+}
+
+// Edmonds-Karp on the layered network takes minutes
+void BenchmarkPushRelabel(bool slow) {
+    std::mt19937_64 rng(1);
+    {
+        static constexpr size_t kLayerCount = 50;
+        static constexpr size_t kLayerWidth = 400;
+        size_t vertex_count = kLayerCount * kLayerWidth + 2;
+        size_t source = vertex_count - 2;
+        size_t target = vertex_count - 1;
+        dinic::Graph graph(vertex_count);
+        for (size_t index = 0; index < kLayerWidth; ++index) {
+            graph[source][index] = 1000;
+            graph[(kLayerCount - 1) * kLayerWidth + index][target] = 1000;
+        }
+        for (size_t layer = 0; layer + 1 < kLayerCount; ++layer) {
+            for (size_t index = 0; index < kLayerWidth; ++index) {
+                for (size_t arc = 0; arc < 10; ++arc) {
+                    graph[layer * kLayerWidth + index]
+                         [(layer + 1) * kLayerWidth + rng() % kLayerWidth] = 1 + rng() % 100;
+                }
+            }
+        }
+        RunMaxFlowFinders("layered 50x400, 10 arcs/vertex", graph, source, target, slow);
+    }
+    {
+        static constexpr size_t kSide = 300;
+        dinic::Graph graph(kSide * kSide);
+        for (size_t row = 0; row < kSide; ++row) {
+            for (size_t column = 0; column < kSide; ++column) {
+                size_t vertex = row * kSide + column;
+                if (column + 1 < kSide) {
+                    graph[vertex][vertex + 1] = 1 + rng() % 100;
+                    graph[vertex + 1][vertex] = 1 + rng() % 100;
+                }
+                if (row + 1 < kSide) {
+                    graph[vertex][vertex + kSide] = 1 + rng() % 100;
+                    graph[vertex + kSide][vertex] = 1 + rng() % 100;
+                }
+            }
+        }
+        RunMaxFlowFinders("grid 300x300", graph, 0, kSide * kSide - 1, true);
+    }
+    RunMaxFlowFinders("random 100k vertexes / 1M arcs", MakeRandomFlowNetwork(&rng), 0, 1,
+                      false);
+}
+
+// the thread counts only show scaling on a machine with that many cores
+void BenchmarkParallelPushRelabel(bool) {
+    std::mt19937_64 rng(1);
+    dinic::Graph graph = MakeRandomFlowNetwork(&rng);
+    push_relabel::Capacity expected = 0;
+    double serial_seconds = MeasureSeconds(
+        [&] { expected = push_relabel::FindMaxFlowPushRelabel(0, 1, graph); });
+    std::printf("parallel_push_relabel: random 100k vertexes / 1M arcs: serial %.2f s\n",
+                serial_seconds);
+    for (size_t thread_count : {1, 2, 4, 8}) {
+        push_relabel::Capacity flow = 0;
+        double seconds = MeasureSeconds([&] {
+            flow = push_relabel::FindMaxFlowParallelPushRelabel(0, 1, graph, thread_count);
+        });
+        assert(flow == expected);
+        std::printf("parallel_push_relabel: %zu threads: %.2f s\n", thread_count, seconds);
+    }
+}
+
+// Kuhn runs only when @with_kuhn
+void RunMatchingFinders(const char* name, std::vector<std::pair<size_t, size_t>> edges,
+                        size_t left_count, size_t right_count, bool with_kuhn) {
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    auto graph = MakeCsrGraph(left_count + right_count, edges);
+    size_t matching_size = 0;
+    double hopcroft_karp_seconds = MeasureSeconds([&] {
+        matching_size = hopcroft_karp::FindMaxMatchingHopcroftKarp(graph, left_count).size();
+    });
+    std::printf("hopcroft_karp: %s: matching %zu, Hopcroft-Karp %.2f s", name, matching_size,
+                hopcroft_karp_seconds);
+    if (with_kuhn) {
+        size_t kuhn_size = 0;
+        double kuhn_seconds =
+            MeasureSeconds([&] { kuhn_size = kuhn::FindMaxMatching(graph, left_count).size(); });
+        assert(kuhn_size == matching_size);
+        std::printf(", Kuhn %.2f s", kuhn_seconds);
+    }
+    std::printf("\n");
+}
+
+// Kuhn on 100k vertexes takes minutes
+void BenchmarkHopcroftKarp(bool slow) {
+    std::mt19937_64 rng(7);
+    for (size_t count : {100000, 300000, 1000000}) {
+        std::vector<std::pair<size_t, size_t>> edges;
+        for (size_t edge = 0; edge < 4 * count; ++edge) {
+            edges.emplace_back(rng() % count, count + rng() % count);
+        }
+        std::string name = "random " + std::to_string(count) + " + " + std::to_string(count) +
+                           " vertexes, 4 edges/vertex";
+        RunMatchingFinders(name.c_str(), std::move(edges), count, count,
+                           slow && count == 100000);
+    }
+    // a perfect matching hidden among random edges, and count / 20 extra left vertexes
+    // which compete for the same right ones and stay unmatched
+    for (size_t count : {100000, 1000000, 4000000}) {
+        size_t left_count = count + count / 20;
+        std::vector<std::pair<size_t, size_t>> edges;
+        for (size_t vertex = 0; vertex < count; ++vertex) {
+            edges.emplace_back(vertex, left_count + vertex);
+            for (size_t edge = 0; edge < 2; ++edge) {
+                edges.emplace_back(vertex, left_count + (vertex + 1 + rng() % (count - 1)) % count);
+            }
+        }
+        for (size_t vertex = count; vertex < left_count; ++vertex) {
+            for (size_t edge = 0; edge < 3; ++edge) {
+                edges.emplace_back(vertex, left_count + rng() % count);
+            }
+        }
+        std::string name = "hidden perfect " + std::to_string(count) + " + " +
+                           std::to_string(count / 20) + " unmatchable";
+        RunMatchingFinders(name.c_str(), std::move(edges), left_count, count,
+                           slow && count == 100000);
+    }
+}
+
+// the thread counts only show scaling on a machine with that many cores
+void BenchmarkParallelMatching(bool) {
+    static constexpr size_t kCount = 300000;
+
+    std::mt19937_64 rng(7);
+    std::vector<std::pair<size_t, size_t>> edges;
+    for (size_t edge = 0; edge < 4 * kCount; ++edge) {
+        edges.emplace_back(rng() % kCount, kCount + rng() % kCount);
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    auto graph = MakeCsrGraph(2 * kCount, edges);
+    size_t expected = 0;
+    double serial_seconds = MeasureSeconds([&] {
+        expected = hopcroft_karp::FindMaxMatchingHopcroftKarp(graph, kCount).size();
+    });
+    std::printf("parallel_matching: random 300k + 300k vertexes, 4 edges/vertex: serial %.2f s\n",
+                serial_seconds);
+    for (size_t thread_count : {1, 2, 4, 8}) {
+        size_t matching_size = 0;
+        double seconds = MeasureSeconds([&] {
+            matching_size =
+                hopcroft_karp::FindMaxMatchingParallel(graph, kCount, thread_count).size();
+        });
+        assert(matching_size == expected);
+        std::printf("parallel_matching: %zu threads: %.2f s\n", thread_count, seconds);
+    }
+}
+
+// the thread counts only show scaling on a machine with that many cores
+void BenchmarkParallelComponents(bool) {
+    static constexpr size_t kVertexCount = 1000000;
+
+    std::mt19937_64 rng(24);
+    std::vector<std::pair<size_t, size_t>> edges;
+    for (size_t edge = 0; edge < kVertexCount; ++edge) {
+        size_t from = rng() % kVertexCount;
+        size_t to = rng() % kVertexCount;
+        edges.emplace_back(from, to);
+        edges.emplace_back(to, from);
+    }
+    auto graph = MakeCsrGraph(kVertexCount, edges);
+    connected_components::ComponentLabels expected;
+    double serial_seconds =
+        MeasureSeconds([&] { expected = connected_components::FindComponentLabels(graph); });
+    std::printf("parallel_components: csr 1M vertexes, 1M random undirected edges: serial %.2f s\n",
+                serial_seconds);
+    for (size_t thread_count : {1, 2, 4, 8}) {
+        connected_components::ComponentLabels result;
+        double seconds = MeasureSeconds([&] {
+            result = connected_components::FindComponentLabelsParallel(graph, thread_count);
+        });
+        assert(result.labels == expected.labels && result.sizes == expected.sizes);
+        std::printf("parallel_components: %zu threads: %.2f s\n", thread_count, seconds);
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::vector<std::pair<std::string, std::function<void(bool)>>> benchmarks = {
+        {"radix_heap", BenchmarkRadixHeap},
+        {"delta_stepping", BenchmarkDeltaStepping},
+        {"dary_heap", BenchmarkDaryHeap},
+        {"push_relabel", BenchmarkPushRelabel},
+        {"capacity_scaling", BenchmarkCapacityScaling},
+        {"parallel_push_relabel", BenchmarkParallelPushRelabel},
+        {"hopcroft_karp", BenchmarkHopcroftKarp},
+        {"parallel_matching", BenchmarkParallelMatching},
+        {"parallel_components", BenchmarkParallelComponents},
+    };
+
+    bool slow = false;
+    std::vector<std::string> names;
+    for (int index = 1; index < argc; ++index) {
+        std::string argument = argv[index];
+        if (argument == "--slow") {
+            slow = true;
+        } else {
+            names.push_back(argument);
+        }
+    }
+    for (const std::string& name : names) {
+        bool is_known = false;
+        for (const auto& benchmark : benchmarks) {
+            is_known = is_known || benchmark.first == name;
+        }
+        if (!is_known) {
+            std::fprintf(stderr, "unknown benchmark %s\n", name.c_str());
+            return 1;
+        }
+    }
+    for (const auto& [name, run] : benchmarks) {
+        bool is_selected = names.empty();
+        for (const std::string& selected : names) {
+            is_selected = is_selected || selected == name;
+        }
+        if (is_selected) {
+            run(slow);
+            std::fflush(stdout);
+        }
+    }
+    return 0;
+}
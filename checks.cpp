@@ -0,0 +1,339 @@
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <utility>
+#include <functional>
+
+#include "Structures/Dijkstra.h"
+#include "Structures/DynamicShortestPaths.h"
+#include "Structures/Kuhn.h"
+#include "Structures/DynamicMatching.h"
+#include "Structures/Dinic.h"
+#include "Structures/IncrementalMaxFlow.h"
+#include "Structures/ParallelPushRelabel.h"
+#include "Structures/HopcroftKarp.h"
+#include "Structures/ParallelMatching.h"
+#include "Structures/ConnectedComponents.h"
+#include "Structures/ParallelConnectedComponents.h"
+
+// Randomized differential checks of the incremental structures against recomputation from
+// scratch. "checks" runs every check, "checks name..." runs the named ones; ctest runs them
+// all under AddressSanitizer and UndefinedBehaviorSanitizer.
+
+// unlike assert, works in release builds too
+#define CHECK(condition)                                                                      \
+    do {                                                                                      \
+        if (!(condition)) {                                                                   \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            std::abort();                                                                     \
+        }                                                                                     \
+    } while (false)
+
+// random edge updates of DynamicShortestPathTree against Dijkstra on the updated graph
+void CheckDynamicShortestPaths() {
+    std::mt19937 rng(9);
+    for (size_t test = 0; test < 300; ++test) {
+        size_t vertex_count = 1 + rng() % 40;
+        dijkstra::Graph graph(vertex_count);
+        for (size_t edge = rng() % 150; edge > 0; --edge) {
+            graph[rng() % vertex_count][rng() % vertex_count] = rng() % 10;
+        }
+        dijkstra::Vertex source = rng() % vertex_count;
+        dijkstra::DynamicShortestPathTree tree(graph, source);
+        CHECK(tree.GetDistances() == dijkstra::Dijkstra(graph, source));
+        for (size_t update = 0; update < 100; ++update) {
+            dijkstra::Vertex from = rng() % vertex_count;
+            dijkstra::Vertex to = rng() % vertex_count;
+            if (rng() % 4 == 0) {
+                tree.RemoveEdge(from, to);
+            } else {
+                tree.SetEdgeWeight(from, to, rng() % 10);
+            }
+            std::vector<dijkstra::Distance> distances =
+                dijkstra::Dijkstra(tree.GetGraph(), source);
+            CHECK(tree.GetDistances() == distances);
+            for (dijkstra::Vertex vertex = 0; vertex < vertex_count; ++vertex) {
+                if (distances[vertex] > 0 && distances[vertex] != dijkstra::kInfDistance) {
+                    dijkstra::Vertex parent = tree.GetParent(vertex);
+                    CHECK(distances[parent] + tree.GetGraph()[parent].at(vertex) ==
+                          distances[vertex]);
+                }
+            }
+        }
+    }
+}
+
+// random edge insertions and deletions of DynamicMatching against Kuhn on the updated graph;
+// the parts are shuffled, so the left part is not a prefix of the vertexes
+void CheckDynamicMatching() {
+    std::mt19937 rng(23);
+    for (size_t test = 0; test < 400; ++test) {
+        size_t vertex_count = 2 + rng() % 30;
+        std::vector<size_t> vertexes(vertex_count);
+        std::iota(vertexes.begin(), vertexes.end(), 0);
+        std::shuffle(vertexes.begin(), vertexes.end(), rng);
+        size_t left_count = 1 + rng() % (vertex_count - 1);
+        std::vector<size_t> left(vertexes.begin(), vertexes.begin() + left_count);
+        std::vector<size_t> right(vertexes.begin() + left_count, vertexes.end());
+        kuhn::Graph graph(vertex_count);
+        for (size_t edge = rng() % (3 * vertex_count); edge > 0; --edge) {
+            graph[left[rng() % left.size()]].insert(right[rng() % right.size()]);
+        }
+        kuhn::DynamicMatching matching(graph, left);
+        for (size_t update = 0; update < 200; ++update) {
+            size_t left_vertex = left[rng() % left.size()];
+            size_t right_vertex = right[rng() % right.size()];
+            if (rng() % 2 == 0) {
+                matching.AddEdge(left_vertex, right_vertex);
+                graph[left_vertex].insert(right_vertex);
+            } else {
+                matching.RemoveEdge(left_vertex, right_vertex);
+                graph[left_vertex].erase(right_vertex);
+            }
+            std::vector<kuhn::Matching> matches = matching.GetMatching();
+            size_t expected_size = kuhn::FindMaxMatching(graph, left).size();
+            CHECK(matches.size() == expected_size);
+            CHECK(matching.GetMatchingSize() == expected_size);
+            std::vector<bool> is_matched(vertex_count, false);
+            for (const kuhn::Matching& match : matches) {
+                CHECK(graph[match.left_part_index].count(match.right_part_index) == 1);
+                CHECK(!is_matched[match.left_part_index] && !is_matched[match.right_part_index]);
+                is_matched[match.left_part_index] = is_matched[match.right_part_index] = true;
+                CHECK(matching.GetMatch(match.left_part_index) == match.right_part_index);
+                CHECK(matching.GetMatch(match.right_part_index) == match.left_part_index);
+            }
+            for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+                CHECK(is_matched[vertex] ==
+                      (matching.GetMatch(vertex) != kuhn::DynamicMatching::kNoVertex));
+            }
+        }
+    }
+}
+
+// random capacity increases, decreases and new edges of IncrementalMaxFlow against Dinic on the
+// updated graph; a quarter of the changes hit edges which leave the target or enter the source
+void CheckDynamicMaxFlow() {
+    std::mt19937 rng(15);
+    for (size_t test = 0; test < 3000; ++test) {
+        size_t vertex_count = 2 + rng() % 12;
+        size_t source = rng() % vertex_count;
+        size_t target = (source + 1 + rng() % (vertex_count - 1)) % vertex_count;
+        dinic::Graph graph(vertex_count);
+        for (size_t edge = rng() % (3 * vertex_count); edge > 0; --edge) {
+            size_t from = rng() % vertex_count;
+            size_t to = rng() % vertex_count;
+            if (from != to) {
+                graph[from][to] = rng() % 20;
+            }
+        }
+        dinic::IncrementalMaxFlow max_flow(graph, source, target);
+        for (size_t update = 0; update < 30; ++update) {
+            size_t from = rng() % vertex_count;
+            size_t to = rng() % vertex_count;
+            if (rng() % 4 == 0) {
+                if (rng() % 2 == 0) {
+                    from = target;
+                } else {
+                    to = source;
+                }
+            }
+            if (from == to) {
+                continue;
+            }
+            dinic::Capacity capacity = max_flow.GetCapacity(from, to);
+            switch (rng() % 3) {
+                case 0:
+                    capacity += 1 + rng() % 10;
+                    break;
+                case 1:
+                    capacity -= std::min<dinic::Capacity>(capacity, 1 + rng() % 10);
+                    break;
+                default:
+                    capacity = rng() % 20;
+            }
+            max_flow.SetCapacity(from, to, capacity);
+            graph[from][to] = capacity;
+            CHECK(max_flow.GetMaxFlow() == dinic::FindMaxFlowDinic(source, target, graph));
+
+            std::vector<dinic::Capacity> balances(vertex_count, 0);
+            for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+                for (const auto& [next, edge_capacity] : graph[vertex]) {
+                    dinic::Capacity flow = max_flow.GetFlow(vertex, next);
+                    CHECK(flow >= 0 && flow <= edge_capacity);
+                    balances[vertex] -= flow;
+                    balances[next] += flow;
+                }
+            }
+            for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+                if (vertex == source) {
+                    CHECK(balances[vertex] == -max_flow.GetMaxFlow());
+                } else if (vertex == target) {
+                    CHECK(balances[vertex] == max_flow.GetMaxFlow());
+                } else {
+                    CHECK(balances[vertex] == 0);
+                }
+            }
+        }
+    }
+}
+
+// the parallel engines run inputs of up to 256 items on the calling thread, so their checks
+// need a few thousand vertexes to go through the thread pool
+constexpr size_t kParallelThreadCount = 4;
+
+// ParallelPushRelabelFinder against Dinic on random networks, in both graph representations
+void CheckParallelPushRelabel() {
+    std::mt19937 rng(13);
+    for (size_t test = 0; test < 20; ++test) {
+        size_t vertex_count = 2000 + rng() % 2000;
+        dinic::Graph graph(vertex_count);
+        std::vector<CsrEdge<dinic::Capacity>> edges;
+        for (size_t edge = 0; edge < 5 * vertex_count; ++edge) {
+            size_t from = rng() % vertex_count;
+            size_t to = rng() % vertex_count;
+            dinic::Capacity capacity = 1 + rng() % 1000;
+            if (from != to) {
+                graph[from][to] += capacity;
+                edges.push_back({from, to, capacity});
+            }
+        }
+        size_t source = rng() % vertex_count;
+        size_t target = (source + 1 + rng() % (vertex_count - 1)) % vertex_count;
+        // wide arcs at both ends make the active sets larger than one chunk
+        for (size_t arc = 0; arc < vertex_count / 4; ++arc) {
+            for (auto [from, to] : {std::pair<size_t, size_t>{source, rng() % vertex_count},
+                                    {rng() % vertex_count, target}}) {
+                if (from != to) {
+                    graph[from][to] += 10000;
+                    edges.push_back({from, to, 10000});
+                }
+            }
+        }
+        dinic::Capacity expected = dinic::FindMaxFlowDinic(source, target, graph);
+        CHECK(push_relabel::FindMaxFlowParallelPushRelabel(source, target, graph,
+                                                           kParallelThreadCount) == expected);
+        CHECK(push_relabel::FindMaxFlowParallelPushRelabel(
+                  source, target, MakeCsrGraph(vertex_count, edges), kParallelThreadCount) ==
+              expected);
+    }
+}
+
+// every match is an edge of @graph and no vertex is matched twice
+bool IsMatching(const kuhn::Graph& graph, const std::vector<kuhn::Matching>& matches) {
+    std::vector<bool> is_matched(graph.size(), false);
+    for (const kuhn::Matching& match : matches) {
+        if (graph[match.left_part_index].count(match.right_part_index) == 0 ||
+            is_matched[match.left_part_index] || is_matched[match.right_part_index]) {
+            return false;
+        }
+        is_matched[match.left_part_index] = is_matched[match.right_part_index] = true;
+    }
+    return true;
+}
+
+// FindMaxMatchingParallel against the serial Hopcroft-Karp on random sparse bipartite graphs,
+// with a shuffled left part and with the first part as the left one, also in CSR
+void CheckParallelMatching() {
+    std::mt19937 rng(21);
+    for (size_t test = 0; test < 20; ++test) {
+        size_t vertex_count = 2000 + rng() % 2000;
+        std::vector<size_t> vertexes(vertex_count);
+        std::iota(vertexes.begin(), vertexes.end(), 0);
+        if (test % 2 == 0) {
+            std::shuffle(vertexes.begin(), vertexes.end(), rng);
+        }
+        size_t left_count = vertex_count / 3 + rng() % (vertex_count / 3);
+        std::vector<size_t> left(vertexes.begin(), vertexes.begin() + left_count);
+        kuhn::Graph graph(vertex_count);
+        std::vector<std::pair<size_t, size_t>> edges;
+        for (size_t edge = 0; edge < 2 * vertex_count; ++edge) {
+            size_t left_vertex = left[rng() % left_count];
+            size_t right_vertex = vertexes[left_count + rng() % (vertex_count - left_count)];
+            if (graph[left_vertex].insert(right_vertex).second) {
+                edges.emplace_back(left_vertex, right_vertex);
+            }
+        }
+        size_t expected = hopcroft_karp::FindMaxMatchingHopcroftKarp(graph, left).size();
+        std::vector<kuhn::Matching> matches =
+            hopcroft_karp::FindMaxMatchingParallel(graph, left, kParallelThreadCount);
+        CHECK(matches.size() == expected);
+        CHECK(IsMatching(graph, matches));
+        if (test % 2 == 1) {
+            CHECK(hopcroft_karp::FindMaxMatchingParallel(graph, left_count, kParallelThreadCount)
+                      .size() == expected);
+            matches = hopcroft_karp::FindMaxMatchingParallel(MakeCsrGraph(vertex_count, edges),
+                                                             left_count, kParallelThreadCount);
+            CHECK(matches.size() == expected);
+            CHECK(IsMatching(graph, matches));
+        }
+    }
+}
+
+// FindComponentLabelsParallel against the serial labels on random graphs from one giant
+// component to many small ones, in both graph representations
+void CheckParallelComponents() {
+    std::mt19937 rng(24);
+    for (size_t test = 0; test < 20; ++test) {
+        size_t vertex_count = 2000 + rng() % 2000;
+        // from 0.25 to 2 edges per vertex, around the threshold of the giant component
+        size_t edge_count = vertex_count * (1 + test % 8) / 4;
+        connected_components::Graph graph(vertex_count);
+        std::vector<std::pair<size_t, size_t>> edges;
+        for (size_t edge = 0; edge < edge_count; ++edge) {
+            size_t from = rng() % vertex_count;
+            size_t to = rng() % vertex_count;
+            graph[from].push_back(to);
+            graph[to].push_back(from);
+            edges.emplace_back(from, to);
+            edges.emplace_back(to, from);
+        }
+        connected_components::ComponentLabels expected =
+            connected_components::FindComponentLabels(graph);
+        for (const connected_components::ComponentLabels& labels :
+             {connected_components::FindComponentLabelsParallel(graph, kParallelThreadCount),
+              connected_components::FindComponentLabelsParallel(MakeCsrGraph(vertex_count, edges),
+                                                                kParallelThreadCount)}) {
+            CHECK(labels.labels == expected.labels);
+            CHECK(labels.sizes == expected.sizes);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::vector<std::pair<std::string, std::function<void()>>> checks = {
+        {"dynamic_shortest_paths", CheckDynamicShortestPaths},
+        {"dynamic_matching", CheckDynamicMatching},
+        {"dynamic_max_flow", CheckDynamicMaxFlow},
+        {"parallel_push_relabel", CheckParallelPushRelabel},
+        {"parallel_matching", CheckParallelMatching},
+        {"parallel_components", CheckParallelComponents},
+    };
+
+    std::vector<std::string> names(argv + 1, argv + argc);
+    for (const std::string& name : names) {
+        bool is_known = false;
+        for (const auto& check : checks) {
+            is_known = is_known || check.first == name;
+        }
+        if (!is_known) {
+            std::fprintf(stderr, "unknown check %s\n", name.c_str());
+            return 1;
+        }
+    }
+    for (const auto& [name, run] : checks) {
+        bool is_selected = names.empty();
+        for (const std::string& selected : names) {
+            is_selected = is_selected || selected == name;
+        }
+        if (is_selected) {
+            run();
+            std::printf("%s: ok\n", name.c_str());
+            std::fflush(stdout);
+        }
+    }
+    return 0;
+}